@@ -16,8 +16,109 @@
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
 #include "driverlib/debug.h"
+#include "driverlib/interrupt.h"
+#include "inc/hw_ints.h"
 #include "USBUART.h"
 
+//********************************************************
+// Static variables
+//********************************************************
+static char rxBuf[UART_RX_LINE_LEN];         // Line being received
+static uint32_t rxLen;
+static char rxLines[UART_RX_LINES][UART_RX_LINE_LEN];   // Complete lines not yet read
+static volatile uint32_t rxWrite = 0;
+static volatile uint32_t rxRead = 0;
+static volatile bool rxOverrun = false;     // A line was dropped since last checked
+static bool rxDiscard = false;              // Line being received is too long to keep
+static volatile bool rxTooLong = false;     // A too long line was dropped since last checked
+static char txBuf[UART_TX_BUF_LEN];         // Characters waiting for the Tx FIFO
+static volatile uint32_t txWrite = 0;
+static volatile uint32_t txRead = 0;
+
+//********************************************************
+// UARTFillTx - Moves characters waiting to be sent into the
+// Tx FIFO until it is full. Called from the interrupt handler,
+// or with the Tx interrupt masked.
+//********************************************************
+static void
+UARTFillTx (void)
+{
+    while (txRead != txWrite && UARTSpaceAvail(UART_USB_BASE))
+    {
+        UARTCharPutNonBlocking(UART_USB_BASE, txBuf[txRead % UART_TX_BUF_LEN]);
+        txRead++;
+    }
+}
+
+//********************************************************
+// UARTStartTx - Tops up the Tx FIFO from outside the interrupt
+// handler. The Tx interrupt only fires as the FIFO drains, so
+// this starts sending when it is idle.
+//********************************************************
+static void
+UARTStartTx (void)
+{
+    UARTIntDisable(UART_USB_BASE, UART_INT_TX);
+    UARTFillTx ();
+    UARTIntEnable(UART_USB_BASE, UART_INT_TX);
+}
+
+//********************************************************
+// UARTIntHandler - Collects received characters into lines
+// and refills the Tx FIFO as it drains.
+//********************************************************
+static void
+UARTIntHandler (void)
+{
+    uint32_t intStatus = UARTIntStatus(UART_USB_BASE, true);
+    UARTIntClear(UART_USB_BASE, intStatus);
+
+    if (intStatus & UART_INT_TX)
+    {
+        UARTFillTx ();
+    }
+
+    while (UARTCharsAvail(UART_USB_BASE))
+    {
+        char c = UARTCharGetNonBlocking(UART_USB_BASE);
+
+        if (c == '\r' || c == '\n')
+        {
+            // Queue a complete line, or note it is lost if it was too long
+            // or the queue is full. Part of a line is never queued.
+            if (rxDiscard)
+            {
+                rxTooLong = true;
+            }
+            else if (rxLen > 0 && rxWrite - rxRead >= UART_RX_LINES)
+            {
+                rxOverrun = true;
+            }
+            else if (rxLen > 0)
+            {
+                char *line = rxLines[rxWrite % UART_RX_LINES];
+                uint32_t i;
+                for (i = 0; i < rxLen; i++)
+                {
+                    line[i] = rxBuf[i];
+                }
+                line[rxLen] = '\0';
+                rxWrite++;
+            }
+            rxLen = 0;
+            rxDiscard = false;
+        }
+        else if (rxLen < UART_RX_LINE_LEN - 1)
+        {
+            rxBuf[rxLen++] = c;
+        }
+        else
+        {
+            rxDiscard = true;
+        }
+    }
+}
+
 
 //********************************************************
 // initUSB_UART - 8 bits, 1 stop bit, no parity
@@ -41,12 +142,19 @@ initUSB_UART (void)
             UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
             UART_CONFIG_PAR_NONE);
     UARTFIFOEnable(UART_USB_BASE);
+
+    // Interrupt on received characters and on receive timeout so
+    // short lines are not left sitting in the FIFO, and as the Tx
+    // FIFO drains.
+    UARTIntRegister(UART_USB_BASE, UARTIntHandler);
+    UARTIntEnable(UART_USB_BASE, UART_INT_RX | UART_INT_RT | UART_INT_TX);
     UARTEnable(UART_USB_BASE);
 }
 
 
 //**********************************************************************
-// Transmit a string via UART0
+// Transmit a string via UART0. The string is queued and sent by the
+// interrupt handler, waiting only if the queue is full.
 //**********************************************************************
 void
 UARTSend (char *pucBuffer)
@@ -54,8 +162,71 @@ UARTSend (char *pucBuffer)
     // Loop while there are more characters to send.
     while(*pucBuffer)
     {
-        // Write the next character to the UART Tx FIFO.
-        UARTCharPut(UART_USB_BASE, *pucBuffer);
+        // Wait for space, keeping the FIFO going in case it ran dry.
+        while (txWrite - txRead >= UART_TX_BUF_LEN)
+        {
+            UARTStartTx ();
+        }
+        txBuf[txWrite % UART_TX_BUF_LEN] = *pucBuffer;
+        txWrite++;
         pucBuffer++;
     }
+    UARTStartTx ();
+}
+
+//**********************************************************************
+// UARTGetLine - Copies the oldest complete line received into line and
+// returns true, or returns false if there are none. line must hold
+// UART_RX_LINE_LEN characters.
+//**********************************************************************
+bool
+UARTGetLine (char *line)
+{
+    const char *rxLine = rxLines[rxRead % UART_RX_LINES];
+    uint32_t i;
+
+    if (rxRead == rxWrite)
+    {
+        return false;
+    }
+
+    for (i = 0; i < UART_RX_LINE_LEN - 1 && rxLine[i]; i++)
+    {
+        line[i] = rxLine[i];
+    }
+    line[i] = '\0';
+    rxRead++;       // Frees the slot for the interrupt handler
+    return true;
+}
+
+//**********************************************************************
+// UARTTakeOverrun - Returns true if a line was dropped because the queue
+// was full since the last call.
+//**********************************************************************
+bool
+UARTTakeOverrun (void)
+{
+    bool overrun = rxOverrun;
+
+    if (overrun)
+    {
+        rxOverrun = false;
+    }
+    return overrun;
+}
+
+//**********************************************************************
+// UARTTakeTooLong - Returns true if a line was dropped because it was
+// longer than UART_RX_LINE_LEN since the last call.
+//**********************************************************************
+bool
+UARTTakeTooLong (void)
+{
+    bool tooLong = rxTooLong;
+
+    if (tooLong)
+    {
+        rxTooLong = false;
+    }
+    return tooLong;
 }
@@ -32,6 +32,9 @@
 #define UART_USB_GPIO_PIN_RX    GPIO_PIN_0
 #define UART_USB_GPIO_PIN_TX    GPIO_PIN_1
 #define UART_USB_GPIO_PINS      UART_USB_GPIO_PIN_RX | UART_USB_GPIO_PIN_TX
+#define UART_RX_LINE_LEN        64      // Longest received line, including terminator
+#define UART_RX_LINES           8       // Received lines queued until read
+#define UART_TX_BUF_LEN         256     // Characters queued to send, a power of 2
 
 //********************************************************
 // initUSB_UART - 8 bits, 1 stop bit, no parity
@@ -40,9 +43,34 @@ void
 initUSB_UART (void);
 
 //**********************************************************************
-// Transmit a string via UART0
+// Transmit a string via UART0. The string is queued and sent by the
+// interrupt handler, waiting only if the queue is full.
 //**********************************************************************
 void
 UARTSend (char *pucBuffer);
 
+//**********************************************************************
+// UARTGetLine - Copies the oldest complete line received into line and
+// returns true, or returns false if there are none. line must hold
+// UART_RX_LINE_LEN characters. Lines end at CR or LF. Up to UART_RX_LINES
+// are queued, later lines are dropped until one is read. Lines too long to
+// fit are dropped whole.
+//**********************************************************************
+bool
+UARTGetLine (char *line);
+
+//**********************************************************************
+// UARTTakeOverrun - Returns true if a line was dropped because the queue
+// was full since the last call.
+//**********************************************************************
+bool
+UARTTakeOverrun (void);
+
+//**********************************************************************
+// UARTTakeTooLong - Returns true if a line was dropped because it was
+// longer than UART_RX_LINE_LEN since the last call.
+//**********************************************************************
+bool
+UARTTakeTooLong (void);
+
 #endif /*USBUART_H_*/
@@ -0,0 +1,140 @@
+// *******************************************************
+//
+// altCal.c
+//
+// Start up altitude calibration. Collects landed ADC samples
+// over several buffer windows to find the landed reading and
+// the sample noise, rejecting the calibration if the rig is
+// moving or the signal is too noisy.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "altCal.h"
+#include "circBufT.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static altCal_t altCal;
+static uint8_t windows;         // Windows seen since calibration started
+static uint32_t windowStart;    // Sample count at the start of the window
+static bool windowStarted;
+static float sumMean, sumVar;
+static float minMean, maxMean;
+
+//*****************************************************************************
+// resetAltCal - Clears the collected statistics.
+//*****************************************************************************
+static void
+resetAltCal (void)
+{
+    windows = 0;
+    windowStarted = false;
+    sumMean = 0;
+    sumVar = 0;
+    minMean = 4096;
+    maxMean = 0;
+}
+
+//*****************************************************************************
+// startAltCal - Starts collecting calibration samples.
+//*****************************************************************************
+void
+startAltCal (void)
+{
+    altCal.rejects = 0;
+    resetAltCal ();
+}
+
+//*****************************************************************************
+// updateAltCal - Adds a window of samples from buffer each time sampleCount
+// shows the buffer has been completely refilled.
+//*****************************************************************************
+enum altCalStatus
+updateAltCal (circBuf_t *buffer, uint32_t sampleCount)
+{
+    uint32_t i;
+    int32_t ref, diff;
+    int32_t sum = 0;
+    int64_t sumSq = 0;
+
+    if (!windowStarted)
+    {
+        windowStart = sampleCount;
+        windowStarted = true;
+        return ALT_CAL_RUNNING;
+    }
+    if (sampleCount - windowStart < buffer->size)
+    {
+        return ALT_CAL_RUNNING;
+    }
+    windowStart = sampleCount;
+
+    // Skip windows that may hold samples from before the ADC settled.
+    if (++windows <= ALT_CAL_SETTLE_WINDOWS)
+    {
+        return ALT_CAL_RUNNING;
+    }
+
+    // Mean and variance of the samples in this window. Sums are of the
+    // difference from the first sample, kept in integers, so the variance
+    // is not lost subtracting two large nearly equal floats.
+    ref = buffer->data[0];
+    for (i = 0; i < buffer->size; i++)
+    {
+        diff = (int32_t) buffer->data[i] - ref;
+        sum += diff;
+        sumSq += (int64_t) diff * diff;
+    }
+    float mean = ref + (float) sum / buffer->size;
+    float var = (float) ((int64_t) buffer->size * sumSq - (int64_t) sum * sum) /
+                ((float) buffer->size * buffer->size);
+
+    sumMean += mean;
+    sumVar += (var > 0) ? var : 0;
+    if (mean < minMean)
+    {
+        minMean = mean;
+    }
+    if (mean > maxMean)
+    {
+        maxMean = mean;
+    }
+
+    if (windows < ALT_CAL_SETTLE_WINDOWS + ALT_CAL_WINDOWS)
+    {
+        return ALT_CAL_RUNNING;
+    }
+
+    // Average the windows. A spread in the means shows the rig was moving.
+    float zero = sumMean / ALT_CAL_WINDOWS;
+    altCal.noise = sqrtf (sumVar / ALT_CAL_WINDOWS);
+    altCal.drift = maxMean - minMean;
+    resetAltCal ();
+
+    if (altCal.drift > ALT_CAL_MAX_DRIFT || altCal.noise > ALT_CAL_MAX_NOISE)
+    {
+        altCal.rejects++;
+        return ALT_CAL_REJECTED;
+    }
+    altCal.zero = (uint16_t) (zero + 0.5f);
+    return ALT_CAL_DONE;
+}
+
+//*****************************************************************************
+// getAltCal - Gets the result of the last calibration.
+//*****************************************************************************
+const altCal_t *
+getAltCal (void)
+{
+    return &altCal;
+}
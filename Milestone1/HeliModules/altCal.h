@@ -0,0 +1,67 @@
+#ifndef ALTCAL_H_
+#define ALTCAL_H_
+
+// *******************************************************
+//
+// altCal.h
+//
+// Start up altitude calibration. Collects landed ADC samples
+// over several buffer windows to find the landed reading and
+// the sample noise, rejecting the calibration if the rig is
+// moving or the signal is too noisy.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circBufT.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define ALT_CAL_SETTLE_WINDOWS  2       // Buffer windows ignored while the buffer fills
+#define ALT_CAL_WINDOWS         20      // Buffer windows used for the calibration
+#define ALT_CAL_MAX_DRIFT       16      // Max spread of window means in ADC counts
+#define ALT_CAL_MAX_NOISE       20      // Max sample standard deviation in ADC counts
+#define ALT_CAL_RETRIES         3       // Rejections before falling back to a saved zero
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum altCalStatus {ALT_CAL_RUNNING = 0, ALT_CAL_DONE, ALT_CAL_REJECTED};
+
+typedef struct {
+    uint16_t zero;          // Mean landed ADC reading
+    float noise;            // Standard deviation of a single sample in ADC counts
+    float drift;            // Spread of the window means in ADC counts
+    uint8_t rejects;        // Calibrations rejected so far
+} altCal_t;
+
+//*****************************************************************************
+// startAltCal - Starts collecting calibration samples.
+//*****************************************************************************
+void
+startAltCal (void);
+
+//*****************************************************************************
+// updateAltCal - Adds a window of samples from buffer each time sampleCount
+// shows the buffer has been completely refilled. Returns ALT_CAL_DONE once
+// enough windows are collected, or ALT_CAL_REJECTED if the rig moved or the
+// samples were too noisy, in which case collection starts again.
+//*****************************************************************************
+enum altCalStatus
+updateAltCal (circBuf_t *buffer, uint32_t sampleCount);
+
+//*****************************************************************************
+// getAltCal - Gets the result of the last calibration.
+//*****************************************************************************
+const altCal_t *
+getAltCal (void);
+
+#endif /* ALTCAL_H_ */
@@ -0,0 +1,197 @@
+// *******************************************************
+//
+// altEstimator.c
+//
+// Kalman filter altitude estimator. Fuses the filtered ADC
+// altitude with the main rotor duty to estimate altitude,
+// vertical velocity and the thrust offset needed to hover,
+// along with the covariance of the estimate.
+//
+// The climb acceleration is modelled as the main duty times
+// a thrust gain plus an offset. The offset holds the weight
+// of the heli and any error in the gain, and is estimated as
+// a slowly drifting state.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "altEstimator.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static altEst_t est;
+static float thrustGain = ALT_EST_THRUST_GAIN;
+static float accNoise = ALT_EST_ACC_NOISE;
+static float measVar = ALT_EST_MIN_MEAS_SD * ALT_EST_MIN_MEAS_SD;
+
+//*****************************************************************************
+// resetAltEstimator - Sets the estimate to rest at alt, with the thrust offset
+// expected to hover at hoverPer main duty.
+//*****************************************************************************
+void
+resetAltEstimator (float alt, float hoverPer)
+{
+    uint8_t i, j;
+
+    est.x[EST_ALT] = alt;
+    est.x[EST_VEL] = 0;
+    est.x[EST_BIAS] = -thrustGain * hoverPer;
+
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = 0; j < EST_STATES; j++)
+        {
+            est.P[i][j] = 0;
+        }
+    }
+    est.P[EST_ALT][EST_ALT] = measVar;
+    est.P[EST_VEL][EST_VEL] = ALT_EST_INIT_VEL_SD * ALT_EST_INIT_VEL_SD;
+    est.P[EST_BIAS][EST_BIAS] = ALT_EST_INIT_BIAS_SD * ALT_EST_INIT_BIAS_SD;
+}
+
+//*****************************************************************************
+// updateAltEstimator - Predicts the estimate forward dt seconds with the
+// main rotor at mainPer duty, then corrects it with the measured altitude.
+//*****************************************************************************
+void
+updateAltEstimator (float measAlt, float mainPer, float dt)
+{
+    float F[EST_STATES][EST_STATES] = {
+        {1, dt, 0.5f * dt * dt},
+        {0, 1,  dt},
+        {0, 0,  1}
+    };
+    float G[EST_STATES] = {0.5f * dt * dt, dt, 0};   // Effect of an acceleration
+    float FP[EST_STATES][EST_STATES];
+    float K[EST_STATES];
+    float P0[EST_STATES];
+    uint8_t i, j, k;
+
+    // Predict: Move the state on with the modelled acceleration.
+    float acc = thrustGain * mainPer + est.x[EST_BIAS];
+    est.x[EST_ALT] += est.x[EST_VEL] * dt + G[EST_ALT] * acc;
+    est.x[EST_VEL] += G[EST_VEL] * acc;
+
+    // Covariance grows by F P F' plus the unmodelled acceleration and drift.
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = 0; j < EST_STATES; j++)
+        {
+            FP[i][j] = 0;
+            for (k = 0; k < EST_STATES; k++)
+            {
+                FP[i][j] += F[i][k] * est.P[k][j];
+            }
+        }
+    }
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = 0; j < EST_STATES; j++)
+        {
+            est.P[i][j] = G[i] * G[j] * accNoise * accNoise;
+            for (k = 0; k < EST_STATES; k++)
+            {
+                est.P[i][j] += FP[i][k] * F[j][k];
+            }
+        }
+    }
+    est.P[EST_BIAS][EST_BIAS] += ALT_EST_BIAS_NOISE * ALT_EST_BIAS_NOISE * dt;
+
+    // Correct: Only the altitude is measured, so the gain is the first
+    // column of P over the innovation variance.
+    float innovation = measAlt - est.x[EST_ALT];
+    float innovationVar = est.P[EST_ALT][EST_ALT] + measVar;
+
+    for (i = 0; i < EST_STATES; i++)
+    {
+        K[i] = est.P[i][EST_ALT] / innovationVar;
+        P0[i] = est.P[EST_ALT][i];
+        est.x[i] += K[i] * innovation;
+    }
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = 0; j < EST_STATES; j++)
+        {
+            est.P[i][j] -= K[i] * P0[j];
+        }
+    }
+
+    // Keep P symmetric against rounding.
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = i + 1; j < EST_STATES; j++)
+        {
+            est.P[i][j] = est.P[j][i] = (est.P[i][j] + est.P[j][i]) / 2;
+        }
+    }
+}
+
+//*****************************************************************************
+// setAltMeasNoise - Sets the SD of the altitude measurements in %.
+//*****************************************************************************
+void
+setAltMeasNoise (float measSd)
+{
+    if (measSd < ALT_EST_MIN_MEAS_SD)
+    {
+        measSd = ALT_EST_MIN_MEAS_SD;
+    }
+    measVar = measSd * measSd;
+}
+
+//*****************************************************************************
+// setAltEstModel - Sets the thrust gain and unmodelled acceleration SD.
+//*****************************************************************************
+void
+setAltEstModel (float newThrustGain, float newAccNoise)
+{
+    // Scale the offset so the estimated hover duty does not change.
+    est.x[EST_BIAS] *= newThrustGain / thrustGain;
+    thrustGain = newThrustGain;
+    accNoise = newAccNoise;
+}
+
+//*****************************************************************************
+// getAltEstModel - Gets the thrust gain and unmodelled acceleration SD.
+//*****************************************************************************
+void
+getAltEstModel (float *thrustGainOut, float *accNoiseOut)
+{
+    *thrustGainOut = thrustGain;
+    *accNoiseOut = accNoise;
+}
+
+//*****************************************************************************
+// getAltEstimate - Returns the estimated altitude in %.
+//*****************************************************************************
+float
+getAltEstimate (void)
+{
+    return est.x[EST_ALT];
+}
+
+//*****************************************************************************
+// getAltVelocity - Returns the estimated vertical velocity in %/s.
+//*****************************************************************************
+float
+getAltVelocity (void)
+{
+    return est.x[EST_VEL];
+}
+
+//*****************************************************************************
+// getAltEst - Gets the full estimate and its covariance.
+//*****************************************************************************
+const altEst_t *
+getAltEst (void)
+{
+    return &est;
+}
@@ -0,0 +1,96 @@
+#ifndef ALTESTIMATOR_H_
+#define ALTESTIMATOR_H_
+
+// *******************************************************
+//
+// altEstimator.h
+//
+// Kalman filter altitude estimator. Fuses the filtered ADC
+// altitude with the main rotor duty to estimate altitude,
+// vertical velocity and the thrust offset needed to hover,
+// along with the covariance of the estimate. Altitudes are
+// in percent of the altitude range.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define ALT_EST_THRUST_GAIN     20.0f   // Climb acceleration in %/s^2 per % of main duty
+#define ALT_EST_ACC_NOISE       50.0f   // SD of unmodelled acceleration in %/s^2
+#define ALT_EST_BIAS_NOISE      20.0f   // SD of thrust offset drift in %/s^2 per root s
+#define ALT_EST_HOVER_PER       40      // Main duty assumed to hover before one is known
+#define ALT_EST_INIT_VEL_SD     10.0f   // SD of the velocity on reset in %/s
+#define ALT_EST_INIT_BIAS_SD    100.0f  // SD of the thrust offset on reset in %/s^2
+#define ALT_EST_MIN_MEAS_SD     0.1f    // Least measurement SD in %, covers ADC resolution
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum altEstState {EST_ALT = 0, EST_VEL, EST_BIAS, EST_STATES};
+
+typedef struct {
+    float x[EST_STATES];                // Altitude %, velocity %/s, thrust offset %/s^2
+    float P[EST_STATES][EST_STATES];    // Covariance of x
+} altEst_t;
+
+//*****************************************************************************
+// resetAltEstimator - Sets the estimate to rest at alt, with the thrust offset
+// expected to hover at hoverPer main duty.
+//*****************************************************************************
+void
+resetAltEstimator (float alt, float hoverPer);
+
+//*****************************************************************************
+// updateAltEstimator - Predicts the estimate forward dt seconds with the
+// main rotor at mainPer duty, then corrects it with the measured altitude.
+//*****************************************************************************
+void
+updateAltEstimator (float measAlt, float mainPer, float dt);
+
+//*****************************************************************************
+// setAltMeasNoise - Sets the SD of the altitude measurements in %.
+//*****************************************************************************
+void
+setAltMeasNoise (float measSd);
+
+//*****************************************************************************
+// setAltEstModel - Sets the thrust gain and unmodelled acceleration SD.
+//*****************************************************************************
+void
+setAltEstModel (float thrustGain, float accNoise);
+
+//*****************************************************************************
+// getAltEstModel - Gets the thrust gain and unmodelled acceleration SD.
+//*****************************************************************************
+void
+getAltEstModel (float *thrustGain, float *accNoise);
+
+//*****************************************************************************
+// getAltEstimate - Returns the estimated altitude in %.
+//*****************************************************************************
+float
+getAltEstimate (void);
+
+//*****************************************************************************
+// getAltVelocity - Returns the estimated vertical velocity in %/s.
+//*****************************************************************************
+float
+getAltVelocity (void);
+
+//*****************************************************************************
+// getAltEst - Gets the full estimate and its covariance.
+//*****************************************************************************
+const altEst_t *
+getAltEst (void);
+
+#endif /* ALTESTIMATOR_H_ */
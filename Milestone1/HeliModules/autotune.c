@@ -0,0 +1,240 @@
+// *******************************************************
+//
+// autotune.c
+//
+// Relay feedback PID autotuner. Replaces the PID output on
+// one axis with a relay around its hover duty, measures the
+// ultimate gain and period of the oscillation that results,
+// and computes PID gains from them.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "driverlib/sysctl.h"
+#include "autotune.h"
+#include "motorControl.h"
+#include "heliPWM.h"
+#include "heliTimer.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static tuneResult_t result;
+static bool armed = false;
+static enum tuneRule tuneRule = AUTOTUNE_RULE;
+static uint32_t baseDuty;       // Hover duty the relay switches around (Q16)
+static uint32_t relayDuty;      // Relay step either side of baseDuty (Q16)
+static int32_t hyst;            // Relay hysteresis, scaled by DUTYSCALER
+static int32_t maxErr;          // Error that aborts the test, scaled by DUTYSCALER
+static bool relayHigh;
+static int32_t cycleMax, cycleMin;  // Error extremes over the current cycle
+static uint32_t riseTime;       // Timer value at the last upward relay switch
+static uint32_t startTime;
+static float sumAmp, sumPeriod;
+
+//*****************************************************************************
+// calcGains - Computes PID gains from the ultimate gain and period using the
+// selected rule, then converts them to the units used by the controllers.
+// Ki is per error summed each update and Kd is per change in error each update.
+//*****************************************************************************
+static void
+calcGains (void)
+{
+    float Kp, Ti, Td;
+
+    if (tuneRule == TUNE_TYREUS_LUYBEN)
+    {
+        Kp = result.Ku / 2.2f;
+        Ti = 2.2f * result.Pu;
+        Td = result.Pu / 6.3f;
+    } else {
+        Kp = 0.6f * result.Ku;
+        Ti = result.Pu / 2;
+        Td = result.Pu / 8;
+    }
+
+    result.gains.Kp = Kp;
+    result.gains.Ki = Kp / Ti * DUTYSCALER / CONTROLLER_RATE;
+    result.gains.Kd = Kp * Td * CONTROLLER_RATE;
+}
+
+//*****************************************************************************
+// endCycle - Records the amplitude and period of a completed relay cycle, and
+// computes the result once enough cycles are seen. Returns true when done.
+//*****************************************************************************
+static bool
+endCycle (uint32_t now)
+{
+    float amp = (float) (cycleMax - cycleMin) / 2 / DUTYSCALER;
+    float period = (float) (riseTime - now) / SysCtlClockGet ();    // Timer counts down
+
+    result.cycles++;
+    if (result.cycles > AUTOTUNE_SKIP_CYCLES)
+    {
+        sumAmp += amp;
+        sumPeriod += period;
+    }
+
+    if (result.cycles < AUTOTUNE_SKIP_CYCLES + AUTOTUNE_CYCLES)
+    {
+        return false;
+    }
+
+    // Describing function of a relay with hysteresis gives the ultimate gain.
+    float a = sumAmp / AUTOTUNE_CYCLES;
+    float eps = (float) hyst / DUTYSCALER;
+    float d = (float) relayDuty * 100 / DUTY_Q16_ONE;
+    result.Pu = sumPeriod / AUTOTUNE_CYCLES;
+    result.Ku = (a > eps) ? 4 * d / (3.14159265f * sqrtf (a * a - eps * eps)) : 0;
+    return true;
+}
+
+//*****************************************************************************
+// armAutotune - Arms or disarms autotuning for the next flight.
+//*****************************************************************************
+void
+armAutotune (bool arm)
+{
+    armed = arm;
+}
+
+//*****************************************************************************
+// autotuneArmed - Returns true if autotuning is armed.
+//*****************************************************************************
+bool
+autotuneArmed (void)
+{
+    return armed;
+}
+
+//*****************************************************************************
+// setAutotuneRule - Selects the rule used to compute gains.
+//*****************************************************************************
+void
+setAutotuneRule (enum tuneRule rule)
+{
+    tuneRule = rule;
+}
+
+//*****************************************************************************
+// startAutotune - Starts a relay test on axis around hoverDuty (Q16), and
+// disarms autotuning.
+//*****************************************************************************
+void
+startAutotune (enum pidAxis axis, uint32_t hoverDuty)
+{
+    armed = false;
+    result.axis = axis;
+    result.status = TUNE_RUNNING;
+    result.cycles = 0;
+    result.Ku = 0;
+    result.Pu = 0;
+
+    baseDuty = hoverDuty;
+    if (axis == AXIS_ALT)
+    {
+        relayDuty = DUTY_PER2Q16(AUTOTUNE_ALT_RELAY_PER);
+        hyst = AUTOTUNE_ALT_HYST * DUTYSCALER;
+        maxErr = AUTOTUNE_ALT_MAX_ERR * DUTYSCALER;
+    } else {
+        relayDuty = DUTY_PER2Q16(AUTOTUNE_YAW_RELAY_PER);
+        hyst = AUTOTUNE_YAW_HYST * DUTYSCALER;
+        maxErr = AUTOTUNE_YAW_MAX_ERR * DUTYSCALER;
+    }
+    if (relayDuty > baseDuty)
+    {
+        relayDuty = baseDuty;
+    }
+
+    relayHigh = true;
+    cycleMax = INT32_MIN;
+    cycleMin = INT32_MAX;
+    sumAmp = 0;
+    sumPeriod = 0;
+    startTime = timerGet ();
+    riseTime = startTime;
+}
+
+//*****************************************************************************
+// updateAutotune - Steps the relay test with the axis error (scaled by
+// DUTYSCALER) and sets duty (Q16) for the axis rotor.
+//*****************************************************************************
+enum tuneStatus
+updateAutotune (int32_t error, uint32_t *duty)
+{
+    uint32_t now = timerGet ();
+
+    if (result.status != TUNE_RUNNING)
+    {
+        *duty = baseDuty;
+        return result.status;
+    }
+
+    // Give up if the heli wanders too far or never settles into a cycle.
+    if (error > maxErr || error < -maxErr ||
+            startTime - now > (uint32_t) AUTOTUNE_TIMEOUT_MS * (SysCtlClockGet () / 1000))
+    {
+        result.status = TUNE_FAILED;
+        *duty = baseDuty;
+        return result.status;
+    }
+
+    if (error > cycleMax)
+    {
+        cycleMax = error;
+    }
+    if (error < cycleMin)
+    {
+        cycleMin = error;
+    }
+
+    // Relay with hysteresis. Each switch to high starts a new cycle.
+    if (relayHigh && error < -hyst)
+    {
+        relayHigh = false;
+    }
+    else if (!relayHigh && error > hyst)
+    {
+        relayHigh = true;
+        if (endCycle (now))
+        {
+            calcGains ();
+            result.status = TUNE_DONE;
+        }
+        riseTime = now;
+        cycleMax = error;
+        cycleMin = error;
+    }
+
+    *duty = relayHigh ? baseDuty + relayDuty : baseDuty - relayDuty;
+    return result.status;
+}
+
+//*****************************************************************************
+// stopAutotune - Abandons a relay test.
+//*****************************************************************************
+void
+stopAutotune (void)
+{
+    if (result.status == TUNE_RUNNING)
+    {
+        result.status = TUNE_FAILED;
+    }
+}
+
+//*****************************************************************************
+// getAutotuneResult - Gets the progress or result of the last relay test.
+//*****************************************************************************
+const tuneResult_t *
+getAutotuneResult (void)
+{
+    return &result;
+}
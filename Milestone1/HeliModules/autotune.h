@@ -0,0 +1,100 @@
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+// *******************************************************
+//
+// autotune.h
+//
+// Relay feedback PID autotuner. Replaces the PID output on
+// one axis with a relay around its hover duty, measures the
+// ultimate gain and period of the oscillation that results,
+// and computes PID gains from them.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motorControl.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define AUTOTUNE_ALT_RELAY_PER  5       // Main duty step either side of hover in %
+#define AUTOTUNE_YAW_RELAY_PER  5       // Tail duty step either side of hover in %
+#define AUTOTUNE_ALT_HYST       1       // Relay hysteresis in % altitude
+#define AUTOTUNE_YAW_HYST       2       // Relay hysteresis in degrees
+#define AUTOTUNE_ALT_MAX_ERR    20      // Altitude error in % that aborts the test
+#define AUTOTUNE_YAW_MAX_ERR    45      // Yaw error in degrees that aborts the test
+#define AUTOTUNE_SKIP_CYCLES    2       // Cycles ignored while the oscillation settles
+#define AUTOTUNE_CYCLES         4       // Cycles averaged for the result
+#define AUTOTUNE_TIMEOUT_MS     40000   // Time per axis before the test gives up
+#define AUTOTUNE_RULE           TUNE_ZIEGLER_NICHOLS    // Default tuning rule
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum tuneRule {TUNE_ZIEGLER_NICHOLS = 0, TUNE_TYREUS_LUYBEN};
+enum tuneStatus {TUNE_IDLE = 0, TUNE_RUNNING, TUNE_DONE, TUNE_FAILED};
+
+typedef struct {
+    enum pidAxis axis;
+    enum tuneStatus status;
+    uint8_t cycles;         // Full relay cycles seen
+    float Ku;               // Ultimate gain in % duty per % or degree
+    float Pu;               // Ultimate period in s
+    pidGains_t gains;       // Gains in controller units
+} tuneResult_t;
+
+//*****************************************************************************
+// armAutotune - Arms or disarms autotuning for the next flight.
+//*****************************************************************************
+void
+armAutotune (bool arm);
+
+//*****************************************************************************
+// autotuneArmed - Returns true if autotuning is armed.
+//*****************************************************************************
+bool
+autotuneArmed (void);
+
+//*****************************************************************************
+// setAutotuneRule - Selects the rule used to compute gains.
+//*****************************************************************************
+void
+setAutotuneRule (enum tuneRule rule);
+
+//*****************************************************************************
+// startAutotune - Starts a relay test on axis around hoverDuty (Q16), and
+// disarms autotuning.
+//*****************************************************************************
+void
+startAutotune (enum pidAxis axis, uint32_t hoverDuty);
+
+//*****************************************************************************
+// updateAutotune - Steps the relay test with the axis error (scaled by
+// DUTYSCALER) and sets duty (Q16) for the axis rotor. Returns TUNE_DONE when
+// the gains are ready in the result, or TUNE_FAILED if the test was aborted.
+// Call at CONTROLLER_RATE.
+//*****************************************************************************
+enum tuneStatus
+updateAutotune (int32_t error, uint32_t *duty);
+
+//*****************************************************************************
+// stopAutotune - Abandons a relay test.
+//*****************************************************************************
+void
+stopAutotune (void);
+
+//*****************************************************************************
+// getAutotuneResult - Gets the progress or result of the last relay test.
+//*****************************************************************************
+const tuneResult_t *
+getAutotuneResult (void);
+
+#endif /* AUTOTUNE_H_ */
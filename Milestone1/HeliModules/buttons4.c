@@ -1,157 +1,267 @@
-// *******************************************************
-// 
-// buttons4.c
-//
-// Support for a set of SIX specific buttons on the Tiva/Orbit.
-// ENCE361 sample code.
-// The buttons are:  UP and DOWN (on the Orbit daughterboard) plus
-// LEFT and RIGHT on the Tiva. They also include a SW on the Orbit
-// board and a Soft Reset button on a input pin.
-//
-// Note that pin PF0 (the pin for the RIGHT pushbutton - SW2 on
-//  the Tiva board) needs special treatment - See PhilsNotesOnTiva.rtf.
-//
-// P.J. Bones UCECE
-// Last modified:  2.5.2019
-// 
-// *******************************************************
-
-#include <stdint.h>
-#include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "driverlib/gpio.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/debug.h"
-#include "inc/tm4c123gh6pm.h"  // Board specific defines (for PF0)
-#include "buttons4.h"
-
-
-// *******************************************************
-// Globals to module
-// *******************************************************
-static bool but_state[NUM_BUTS];	// Corresponds to the electrical state
-static uint8_t but_count[NUM_BUTS];
-static bool but_flag[NUM_BUTS];
-static bool but_normal[NUM_BUTS];   // Corresponds to the electrical state
-
-// *******************************************************
-// initButtons: Initialise the variables associated with the set of buttons
-// defined by the constants in the buttons2.h header file.
-void
-initButtons (void)
-{
-	int i;
-
-	// UP button (active HIGH)
-    SysCtlPeripheralEnable (UP_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (UP_BUT_PORT_BASE, UP_BUT_PIN);
-    GPIOPadConfigSet (UP_BUT_PORT_BASE, UP_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPD);
-    but_normal[UP] = UP_BUT_NORMAL;
-	// DOWN button (active HIGH)
-    SysCtlPeripheralEnable (DOWN_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN);
-    GPIOPadConfigSet (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPD);
-    but_normal[DOWN] = DOWN_BUT_NORMAL;
-    // LEFT button (active LOW)
-    SysCtlPeripheralEnable (LEFT_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN);
-    GPIOPadConfigSet (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPU);
-    but_normal[LEFT] = LEFT_BUT_NORMAL;
-    // RIGHT button (active LOW)
-    // Note that PF0 is one of a handful of GPIO pins that need to be
-    // "unlocked" before they can be reconfigured.  This also requires
-    //      #include "inc/tm4c123gh6pm.h"
-    SysCtlPeripheralEnable (RIGHT_BUT_PERIPH);
-    //---Unlock PF0 for the right button:
-    GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
-    GPIO_PORTF_CR_R |= GPIO_PIN_0; //PF0 unlocked
-    GPIO_PORTF_LOCK_R = GPIO_LOCK_M;
-    GPIOPinTypeGPIOInput (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN);
-    GPIOPadConfigSet (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPU);
-    but_normal[RIGHT] = RIGHT_BUT_NORMAL;
-
-    // STATE SWITCH (active HIGH)
-    SysCtlPeripheralEnable (SW_PERIPH);
-    GPIOPinTypeGPIOInput (SW_PORT_BASE, SW_PIN);
-    GPIOPadConfigSet (SW_PORT_BASE, SW_PIN, GPIO_STRENGTH_2MA,
-                      GPIO_PIN_TYPE_STD_WPD);
-    but_normal[SW] = SW_BUT_NORMAL;
-
-    // RESET SWITCH (active LOW)
-    SysCtlPeripheralEnable (RESET_PERIPH);
-    GPIOPinTypeGPIOInput (RESET_PORT_BASE, RESET_PIN);
-    GPIOPadConfigSet (RESET_PORT_BASE, RESET_PIN, GPIO_STRENGTH_2MA,
-                          GPIO_PIN_TYPE_STD_WPU);
-    but_normal[RESET] = RESET_BUT_NORMAL;
-
-	for (i = 0; i < NUM_BUTS; i++)
-	{
-		but_state[i] = but_normal[i];
-		but_count[i] = 0;
-		but_flag[i] = false;
-	}
-}
-
-// *******************************************************
-// updateButtons: Function designed to be called regularly. It polls all
-// buttons once and updates variables associated with the buttons if
-// necessary.  It is efficient enough to be part of an ISR, e.g. from
-// a SysTick interrupt.
-// Debounce algorithm: A state machine is associated with each button.
-// A state change occurs only after NUM_BUT_POLLS consecutive polls have
-// read the pin in the opposite condition, before the state changes and
-// a flag is set.  Set NUM_BUT_POLLS according to the polling rate.
-void
-updateButtons (void)
-{
-	bool but_value[NUM_BUTS];
-	int i;
-	
-	// Read the pins; true means HIGH, false means LOW
-	but_value[UP] = (GPIOPinRead (UP_BUT_PORT_BASE, UP_BUT_PIN) == UP_BUT_PIN);
-	but_value[DOWN] = (GPIOPinRead (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN) == DOWN_BUT_PIN);
-    but_value[LEFT] = (GPIOPinRead (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN) == LEFT_BUT_PIN);
-    but_value[RIGHT] = (GPIOPinRead (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN) == RIGHT_BUT_PIN);
-    but_value[SW] = (GPIOPinRead (SW_PORT_BASE, SW_PIN) == SW_PIN);
-    but_value[RESET] = (GPIOPinRead (RESET_PORT_BASE, RESET_PIN) == RESET_PIN);
-	// Iterate through the buttons, updating button variables as required
-	for (i = 0; i < NUM_BUTS; i++)
-	{
-        if (but_value[i] != but_state[i])
-        {
-        	but_count[i]++;
-        	if (but_count[i] >= NUM_BUT_POLLS)
-        	{
-        		but_state[i] = but_value[i];
-        		but_flag[i] = true;	   // Reset by call to checkButton()
-        		but_count[i] = 0;
-        	}
-        }
-        else
-        	but_count[i] = 0;
-	}
-}
-
-// *******************************************************
-// checkButton: Function returns the new button logical state if the button
-// logical state (PUSHED or RELEASED) has changed since the last call,
-// otherwise returns NO_CHANGE.
-enum butStates
-checkButton (uint8_t butName)
-{
-	if (but_flag[butName])
-	{
-		but_flag[butName] = false;
-		if (but_state[butName] == but_normal[butName])
-			return RELEASED;
-		else
-			return PUSHED;
-	}
-	return NO_CHANGE;
-}
-
+// *******************************************************
+// 
+// buttons4.c
+//
+// Support for a set of SIX specific buttons on the Tiva/Orbit.
+// ENCE361 sample code.
+// The buttons are:  UP and DOWN (on the Orbit daughterboard) plus
+// LEFT and RIGHT on the Tiva. They also include a SW on the Orbit
+// board and a Soft Reset button on a input pin.
+//
+// Note that pin PF0 (the pin for the RIGHT pushbutton - SW2 on
+//  the Tiva board) needs special treatment - See PhilsNotesOnTiva.rtf.
+//
+// P.J. Bones UCECE
+// Last modified:  2.5.2019
+// 
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/debug.h"
+#include "driverlib/interrupt.h"
+#include "inc/tm4c123gh6pm.h"  // Board specific defines (for PF0)
+#include "buttons4.h"
+
+
+// *******************************************************
+// Globals to module
+// *******************************************************
+static uint32_t but_state;          // Debounced logical state, bit set when pushed
+static uint32_t but_count0;         // Low bit of each button's vertical counter
+static uint32_t but_count1;         // High bit of each button's vertical counter
+static volatile uint32_t but_flag;  // Bit set when button state changes
+static uint32_t but_long;           // Bit set once button has given a LONG_PRESS
+static uint16_t but_hold[NUM_BUTS]; // Polls left until next LONG_PRESS or REPEAT
+static uint16_t but_long_polls = BUT_LONG_PRESS_POLLS;
+static uint16_t but_repeat_polls = BUT_REPEAT_POLLS;
+static uint32_t but_ticks;          // Poll count used to timestamp events
+static uint32_t but_dropped;        // Events lost to a full queue
+// Event queue, windex only written by updateButtons and rindex only by
+// getButtonEvent so no locking is needed.
+static butEvent_t but_events[BUT_EVENT_QUEUE_SIZE];
+static volatile uint32_t but_windex;
+static volatile uint32_t but_rindex;
+
+// *******************************************************
+// initButtons: Initialise the variables associated with the set of buttons
+// defined by the constants in the buttons2.h header file.
+void
+initButtons (void)
+{
+	// UP button (active HIGH)
+    SysCtlPeripheralEnable (UP_BUT_PERIPH);
+    GPIOPinTypeGPIOInput (UP_BUT_PORT_BASE, UP_BUT_PIN);
+    GPIOPadConfigSet (UP_BUT_PORT_BASE, UP_BUT_PIN, GPIO_STRENGTH_2MA,
+       GPIO_PIN_TYPE_STD_WPD);
+	// DOWN button (active HIGH)
+    SysCtlPeripheralEnable (DOWN_BUT_PERIPH);
+    GPIOPinTypeGPIOInput (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN);
+    GPIOPadConfigSet (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN, GPIO_STRENGTH_2MA,
+       GPIO_PIN_TYPE_STD_WPD);
+    // LEFT button (active LOW)
+    SysCtlPeripheralEnable (LEFT_BUT_PERIPH);
+    GPIOPinTypeGPIOInput (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN);
+    GPIOPadConfigSet (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN, GPIO_STRENGTH_2MA,
+       GPIO_PIN_TYPE_STD_WPU);
+    // RIGHT button (active LOW)
+    // Note that PF0 is one of a handful of GPIO pins that need to be
+    // "unlocked" before they can be reconfigured.  This also requires
+    //      #include "inc/tm4c123gh6pm.h"
+    SysCtlPeripheralEnable (RIGHT_BUT_PERIPH);
+    //---Unlock PF0 for the right button:
+    GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
+    GPIO_PORTF_CR_R |= GPIO_PIN_0; //PF0 unlocked
+    GPIO_PORTF_LOCK_R = GPIO_LOCK_M;
+    GPIOPinTypeGPIOInput (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN);
+    GPIOPadConfigSet (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN, GPIO_STRENGTH_2MA,
+       GPIO_PIN_TYPE_STD_WPU);
+
+    // STATE SWITCH (active HIGH)
+    SysCtlPeripheralEnable (SW_PERIPH);
+    GPIOPinTypeGPIOInput (SW_PORT_BASE, SW_PIN);
+    GPIOPadConfigSet (SW_PORT_BASE, SW_PIN, GPIO_STRENGTH_2MA,
+                      GPIO_PIN_TYPE_STD_WPD);
+
+    // RESET SWITCH (active LOW)
+    SysCtlPeripheralEnable (RESET_PERIPH);
+    GPIOPinTypeGPIOInput (RESET_PORT_BASE, RESET_PIN);
+    GPIOPadConfigSet (RESET_PORT_BASE, RESET_PIN, GPIO_STRENGTH_2MA,
+                          GPIO_PIN_TYPE_STD_WPU);
+
+    but_state = 0;
+    but_count0 = 0;
+    but_count1 = 0;
+    but_flag = 0;
+    but_long = 0;
+    but_ticks = 0;
+    but_dropped = 0;
+    but_windex = 0;
+    but_rindex = 0;
+}
+
+// *******************************************************
+// queueButtonEvent: Adds an event to the button event queue, counting it
+// as dropped if the queue is full.
+static void
+queueButtonEvent (uint8_t butName, enum butEventType type)
+{
+    butEvent_t *event;
+
+    if (but_windex - but_rindex >= BUT_EVENT_QUEUE_SIZE)
+    {
+        but_dropped++;
+        return;
+    }
+    event = &but_events[but_windex & (BUT_EVENT_QUEUE_SIZE - 1)];
+    event->butName = butName;
+    event->type = type;
+    event->time = but_ticks;
+    but_windex++;      // Publish only once the event is complete
+}
+
+// *******************************************************
+// updateButtons: Function designed to be called regularly. It polls all
+// buttons once and updates variables associated with the buttons if
+// necessary.  It is efficient enough to be part of an ISR, e.g. from
+// a SysTick interrupt.
+// Debounce algorithm: Each port is read once and the pins packed into a
+// word. A two bit vertical counter per button counts consecutive polls
+// that differ from the debounced state, for all buttons at once. A state
+// change occurs only after NUM_BUT_POLLS consecutive polls have read the
+// pin in the opposite condition, before the state changes and a flag is
+// set. Returns a bitmask of buttons pushed (low half word) and released
+// (high half word) on this poll.
+uint32_t
+updateButtons (void)
+{
+    uint32_t portA, portD, portE, portF;
+    uint32_t but_value;
+    uint32_t delta;
+    uint32_t toggle;
+    uint32_t pushed, released, held;
+    uint8_t i;
+
+    but_ticks++;
+
+    // Read the pins; one read per port
+    portA = GPIOPinRead (SW_PORT_BASE, BUT_PORTA_PINS);
+    portD = GPIOPinRead (DOWN_BUT_PORT_BASE, BUT_PORTD_PINS);
+    portE = GPIOPinRead (UP_BUT_PORT_BASE, BUT_PORTE_PINS);
+    portF = GPIOPinRead (LEFT_BUT_PORT_BASE, BUT_PORTF_PINS);
+
+    // Pack into one word, bit set means HIGH, then make bit set mean pushed
+    but_value = ((portE & UP_BUT_PIN) != 0) << UP |
+                ((portD & DOWN_BUT_PIN) != 0) << DOWN |
+                ((portF & LEFT_BUT_PIN) != 0) << LEFT |
+                ((portF & RIGHT_BUT_PIN) != 0) << RIGHT |
+                ((portA & SW_PIN) != 0) << SW |
+                ((portA & RESET_PIN) != 0) << RESET;
+    but_value ^= BUT_NORMAL_MASK;
+
+    // Advance counters of buttons differing from their state, clear the rest.
+    // A counter wrapping back to zero toggles that button's state.
+    delta = but_value ^ but_state;
+    but_count1 = (but_count1 ^ but_count0) & delta;
+    but_count0 = ~but_count0 & delta;
+    toggle = delta & ~(but_count0 | but_count1);
+
+    but_state ^= toggle;
+    but_flag |= toggle;	   // Reset by call to checkButton()
+    pushed = toggle & but_state;
+    released = toggle & ~but_state;
+
+    // Queue events for buttons that changed or are being held down.
+    // Only runs the loop body when at least one button is active.
+    held = (pushed | released | but_state) & BUT_EVENT_MASK;
+    for (i = 0; held; i++, held >>= 1)
+    {
+        uint32_t butBit = BUT_BIT(i);
+
+        if (!(held & 1))
+            continue;
+        if (pushed & butBit)
+        {
+            queueButtonEvent (i, BUT_PUSHED);
+            but_hold[i] = but_long_polls;
+            but_long &= ~butBit;
+        }
+        else if (released & butBit)
+        {
+            queueButtonEvent (i, BUT_RELEASED);
+        }
+        else if ((butBit & BUT_REPEAT_MASK) && --but_hold[i] == 0)
+        {
+            queueButtonEvent (i, (but_long & butBit) ? BUT_REPEAT : BUT_LONG_PRESS);
+            but_hold[i] = but_repeat_polls;
+            but_long |= butBit;
+        }
+    }
+
+    return pushed | released << 16;
+}
+
+// *******************************************************
+// checkButton: Function returns the new button logical state if the button
+// logical state (PUSHED or RELEASED) has changed since the last call,
+// otherwise returns NO_CHANGE. Safe to call from an ISR or with interrupts
+// masked.
+enum butStates
+checkButton (uint8_t butName)
+{
+	uint32_t butBit = BUT_BIT(butName);
+	bool wasMasked;
+
+	if (but_flag & butBit)
+	{
+		// Clear flag with interrupts off so no flag set by updateButtons is lost.
+		// Left off if they were already, as when called from an ISR.
+		wasMasked = IntMasterDisable ();
+		but_flag &= ~butBit;
+		if (!wasMasked)
+			IntMasterEnable ();
+		if (but_state & butBit)
+			return PUSHED;
+		else
+			return RELEASED;
+	}
+	return NO_CHANGE;
+}
+
+// *******************************************************
+// getButtonEvent: Function takes the oldest event from the button event
+// queue and copies it to event. Returns false if the queue is empty.
+// Safe to call while updateButtons runs in an ISR.
+bool
+getButtonEvent (butEvent_t *event)
+{
+	if (but_rindex == but_windex)
+		return false;
+	*event = but_events[but_rindex & (BUT_EVENT_QUEUE_SIZE - 1)];
+	but_rindex++;      // Free the slot only once it has been copied
+	return true;
+}
+
+// *******************************************************
+// setButtonRepeat: Function sets the hold time before a LONG_PRESS event
+// and the time between REPEAT events, both in polls of updateButtons.
+void
+setButtonRepeat (uint16_t longPressPolls, uint16_t repeatPolls)
+{
+	// Zero would never count down to a LONG_PRESS or REPEAT event
+	but_long_polls = (longPressPolls > 0) ? longPressPolls : 1;
+	but_repeat_polls = (repeatPolls > 0) ? repeatPolls : 1;
+}
+
+// *******************************************************
+// getButtonEventsDropped: Function returns the number of events lost
+// because the event queue was full.
+uint32_t
+getButtonEventsDropped (void)
+{
+	return but_dropped;
+}
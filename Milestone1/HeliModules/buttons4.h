@@ -23,6 +23,7 @@
 //*****************************************************************************
 enum butNames {UP = 0, DOWN, LEFT, RIGHT, SW, RESET, NUM_BUTS};
 enum butStates {RELEASED = 0, PUSHED, NO_CHANGE};
+enum butEventType {BUT_PUSHED = 0, BUT_RELEASED, BUT_LONG_PRESS, BUT_REPEAT};
 // UP button
 #define UP_BUT_PERIPH  SYSCTL_PERIPH_GPIOE
 #define UP_BUT_PORT_BASE  GPIO_PORTE_BASE
@@ -54,11 +55,45 @@ enum butStates {RELEASED = 0, PUSHED, NO_CHANGE};
 #define RESET_PIN          GPIO_PIN_6
 #define RESET_BUT_NORMAL   true
 
-#define NUM_BUT_POLLS 3
-// Debounce algorithm: A state machine is associated with each button.
-// A state change occurs only after NUM_BUT_POLLS consecutive polls have
-// read the pin in the opposite condition, before the state changes and
-// a flag is set.  Set NUM_BUT_POLLS according to the polling rate.
+// Pins read together from each port, packed into one word with bit
+// butName set when that button is HIGH.
+#define BUT_PORTA_PINS  (SW_PIN | RESET_PIN)
+#define BUT_PORTD_PINS  DOWN_BUT_PIN
+#define BUT_PORTE_PINS  UP_BUT_PIN
+#define BUT_PORTF_PINS  (LEFT_BUT_PIN | RIGHT_BUT_PIN)
+#define BUT_BIT(B)      (1 << (B))
+// Word of the pins with a HIGH normal state, XORed with the packed pins
+// so that a set bit always means the button is pushed.
+#define BUT_NORMAL_MASK ((UP_BUT_NORMAL << UP) | (DOWN_BUT_NORMAL << DOWN) | \
+                         (LEFT_BUT_NORMAL << LEFT) | (RIGHT_BUT_NORMAL << RIGHT) | \
+                         (SW_BUT_NORMAL << SW) | (RESET_BUT_NORMAL << RESET))
+
+#define NUM_BUT_POLLS 4
+// Debounce algorithm: A two bit vertical counter is associated with each
+// button, with the counters for all buttons updated in parallel using
+// bitwise operations on the packed word. A state change occurs only after
+// NUM_BUT_POLLS consecutive polls have read the pin in the opposite
+// condition, before the state changes and a flag is set. NUM_BUT_POLLS is
+// fixed at 4 by the width of the vertical counter.
+
+// Button events: Buttons in BUT_EVENT_MASK push timestamped events onto a
+// queue read with getButtonEvent, so pushes between reads are not lost.
+// Holding a button in BUT_REPEAT_MASK gives a LONG_PRESS event after the
+// long press time, then a REPEAT event every repeat time until released.
+// Times are in polls of updateButtons (1 ms at a 1 kHz poll rate).
+#define BUT_EVENT_QUEUE_SIZE    16      // Must be a power of 2
+#define BUT_EVENT_MASK          (BUT_BIT(UP) | BUT_BIT(DOWN) | BUT_BIT(LEFT) | BUT_BIT(RIGHT))
+#define BUT_REPEAT_MASK         BUT_EVENT_MASK
+#define BUT_LONG_PRESS_POLLS    500
+#define BUT_REPEAT_POLLS        150
+
+// *******************************************************
+// Button event structure
+typedef struct {
+    uint8_t             butName;    // Button the event is for
+    enum butEventType   type;       // PUSHED, RELEASED, LONG_PRESS or REPEAT
+    uint32_t            time;       // Poll count when event occurred
+} butEvent_t;
 
 // *******************************************************
 // initButtons: Initialise the variables associated with the set of buttons
@@ -70,8 +105,9 @@ initButtons (void);
 // updateButtons: Function designed to be called regularly. It polls all
 // buttons once and updates variables associated with the buttons if
 // necessary.  It is efficient enough to be part of an ISR, e.g. from
-// a SysTick interrupt.
-void
+// a SysTick interrupt. Returns a bitmask of buttons pushed (low half
+// word) and released (high half word) on this poll.
+uint32_t
 updateButtons (void);
 
 // *******************************************************
@@ -82,4 +118,23 @@ updateButtons (void);
 enum butStates
 checkButton (uint8_t butName);
 
+// *******************************************************
+// getButtonEvent: Function takes the oldest event from the button event
+// queue and copies it to event. Returns false if the queue is empty.
+// Safe to call while updateButtons runs in an ISR.
+bool
+getButtonEvent (butEvent_t *event);
+
+// *******************************************************
+// setButtonRepeat: Function sets the hold time before a LONG_PRESS event
+// and the time between REPEAT events, both in polls of updateButtons.
+void
+setButtonRepeat (uint16_t longPressPolls, uint16_t repeatPolls);
+
+// *******************************************************
+// getButtonEventsDropped: Function returns the number of events lost
+// because the event queue was full.
+uint32_t
+getButtonEventsDropped (void);
+
 #endif /*BUTTONS_H_*/
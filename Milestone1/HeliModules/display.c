@@ -15,7 +15,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include "OrbitOLED/OrbitOLEDInterface.h"
+#include "OrbitOLED/lib_OrbitOled/OrbitOled.h"
 #include "utils/ustdlib.h"
 #include "display.h"
 #include "yaw.h"
@@ -27,6 +30,8 @@
 //*****************************************************************************
 const uint16_t outADC_min = 0;      // Mapping values to restrict the alt to 0-100%
 const uint16_t outADC_max = 100;
+static uint8_t scopePageFill[SCOPE_PAGES];  // Number of non blank columns in each page
+static uint8_t scopeColCount;               // Column counter for dotted traces
 
 //*****************************************************************************
 // Initialise OrbitOLED display.
@@ -48,15 +53,16 @@ map(int16_t val, uint16_t min_in, uint16_t max_in, uint16_t min_out, uint16_t ma
 }
 
 //*****************************************************************************
-// Function to map input ADC value to altitude range in percent.
+// Function to map input ADC value to altitude range in percent, given the ADC
+// value when landed and the change in ADC value from landed to full altitude.
+// Keeps the fraction of a percent for the altitude estimator.
 //*****************************************************************************
-int16_t
-mapAlt(uint16_t meanVal, uint16_t inADCMax)
+float
+mapAlt(uint16_t meanVal, uint16_t altZero, uint16_t altRange)
 {
-    int16_t scaledVal = ALT_RANGE - (meanVal - inADCMax);
-    int16_t mappedVal = map(scaledVal, 0, ALT_RANGE, outADC_min, outADC_max);
+    float scaledVal = (float) altZero - meanVal;
 
-    return mappedVal;
+    return scaledVal * (outADC_max - outADC_min) / altRange + outADC_min;
 }
 
 //*****************************************************************************
@@ -77,11 +83,15 @@ displayMeanVal(int16_t mappedAlt, uint16_t desiredAlt)
 // Function to display the yaw value in degrees to display
 //*****************************************************************************
 void
-displayYaw(int16_t mappedYaw, int32_t desiredYaw)
+displayYaw(yawAngle_t yawAngle, int32_t desiredYaw)
 {
     char string[MAX_DISP_LEN + 1];  // 16 characters across the display
+    int16_t yawDeciDeg = YAW_ANGLE2DDEG(yawAngle);
+    char sign = (yawDeciDeg < 0) ? '-' : ' ';
 
-    usnprintf (string, sizeof(string), "YAW:%4d [%3d]\n", mappedYaw, mapYaw2Deg(desiredYaw, true));
+    yawDeciDeg = abs(yawDeciDeg);
+    usnprintf (string, sizeof(string), "YAW%c%3d.%d [%4d]", sign, yawDeciDeg / 10,
+               yawDeciDeg % 10, mapYaw2Deg(desiredYaw, true));
 
     // Update line on display, first line.
     OLEDStringDraw (string, 0, 0);
@@ -98,7 +108,8 @@ displayPWM(rotor_t *main, rotor_t *tail)
 
     if (main->state && tail->state)
     {
-        usnprintf (string, sizeof(string), "MAIN %2d TAIL %2d", main->duty, tail->duty);
+        usnprintf (string, sizeof(string), "MAIN %2d TAIL %2d", DUTY_Q162PER(main->duty),
+                   DUTY_Q162PER(tail->duty));
     } else {
         usnprintf (string, sizeof(string), "MAIN %2d TAIL %2d", 0, 0);
     }
@@ -115,10 +126,110 @@ void
 displayState(enum state heliState)
 {
     char string[MAX_DISP_LEN + 1];  // 16 characters across the display
-    char* state[] = {"LD", "TF", "FL", "LG", "ER"};
+    char* state[] = {"LD", "TF", "FL", "LG", "AT", "MS", "ER"};
 
     usnprintf (string, sizeof(string), "Heli State: %s", state[heliState]);
 
     // Update line on display, fourth line.
     OLEDStringDraw (string, 0, 3);
 }
+
+//*****************************************************************************
+// Function to show altitude calibration is in progress and how many attempts
+// were rejected because the rig was moving.
+//*****************************************************************************
+void
+displayCalibrating(uint8_t rejects)
+{
+    char string[MAX_DISP_LEN + 1];  // 16 characters across the display
+
+    OLEDStringDraw ("Calibrating alt", 0, 0);
+    if (rejects)
+    {
+        usnprintf (string, sizeof(string), "Keep still %3d", rejects);
+        OLEDStringDraw (string, 0, 1);
+    }
+}
+
+//*****************************************************************************
+// Function to clear the display and reset the scope screen.
+//*****************************************************************************
+void
+displayClear(void)
+{
+    OrbitOledClear ();
+    memset (scopePageFill, 0, sizeof(scopePageFill));
+    scopeColCount = 0;
+}
+
+//*****************************************************************************
+// Function to set a pixel in a single display column, row 0 is the top.
+//*****************************************************************************
+static void
+scopeSetPixel(char *column, int16_t row)
+{
+    column[row / 8] |= 1 << (row % 8);
+}
+
+//*****************************************************************************
+// Function to add a sample to the scrolling altitude and yaw error scope.
+// Shifts the display one column left and only flushes pages that changed.
+//*****************************************************************************
+void
+displayScope(int16_t mappedAlt, int16_t desiredAlt, int16_t yawError)
+{
+    char newCol[SCOPE_PAGES] = {0};
+    int16_t yawRows;
+    uint8_t page;
+
+    // Limit altitude values to the plotted range.
+    if (mappedAlt < outADC_min) mappedAlt = outADC_min;
+    if (mappedAlt > outADC_max) mappedAlt = outADC_max;
+    if (desiredAlt < outADC_min) desiredAlt = outADC_min;
+    if (desiredAlt > outADC_max) desiredAlt = outADC_max;
+
+    // Altitude is a solid trace, desired altitude is dotted.
+    scopeSetPixel (newCol, (SCOPE_ALT_ROWS - 1) -
+                   map(mappedAlt, outADC_min, outADC_max, 0, SCOPE_ALT_ROWS - 1));
+    if (scopeColCount % 2 == 0)
+    {
+        scopeSetPixel (newCol, (SCOPE_ALT_ROWS - 1) -
+                       map(desiredAlt, outADC_min, outADC_max, 0, SCOPE_ALT_ROWS - 1));
+    }
+
+    // Yaw error is plotted about a dotted zero line, positive error upwards.
+    yawRows = yawError / SCOPE_YAW_DEG_PER_ROW;
+    if (yawRows > SCOPE_YAW_MAX_ROWS) yawRows = SCOPE_YAW_MAX_ROWS;
+    if (yawRows < -SCOPE_YAW_MAX_ROWS) yawRows = -SCOPE_YAW_MAX_ROWS;
+    scopeSetPixel (newCol, SCOPE_YAW_CENTRE_ROW - yawRows);
+    if (scopeColCount % SCOPE_DOT_SPACING == 0)
+    {
+        scopeSetPixel (newCol, SCOPE_YAW_CENTRE_ROW);
+    }
+    scopeColCount++;
+
+    // Scroll each page one column left and append the new column. Only pages
+    // that held or gained pixels have changed and need sending to the display.
+    for (page = 0; page < SCOPE_PAGES; page++)
+    {
+        char *pb = &rgbOledBmp[page * ccolOledMax];
+        bool dirty = scopePageFill[page] > 0;
+
+        if (pb[0])
+        {
+            scopePageFill[page]--;
+        }
+        memmove (pb, pb + 1, ccolOledMax - 1);
+        pb[ccolOledMax - 1] = newCol[page];
+        if (newCol[page])
+        {
+            scopePageFill[page]++;
+            dirty = true;
+        }
+
+        if (dirty)
+        {
+            OrbitOledUpdatePage (page);
+        }
+    }
+}
@@ -19,13 +19,22 @@
 #include <stdbool.h>
 #include "heliPWM.h"
 #include "stateMachine.h"
+#include "yaw.h"
 
 //*****************************************************************************
 // Constants
 //*****************************************************************************
-#define ALT_RANGE 800                 // Range of voltage for altitude reading
+#define ALT_RANGE 800                 // Default range of voltage for altitude reading
 #define MAX_DISP_LEN 16
 
+//---Scope screen layout, pages 0-2 plot altitude and page 3 plots yaw error
+#define SCOPE_PAGES             4     // Number of 8 row display pages used by scope
+#define SCOPE_ALT_ROWS          24    // Rows used for altitude trace (0-100%)
+#define SCOPE_YAW_CENTRE_ROW    28    // Row of zero yaw error
+#define SCOPE_YAW_MAX_ROWS      3     // Max rows yaw trace can move from centre
+#define SCOPE_YAW_DEG_PER_ROW   5     // Degrees of yaw error per row
+#define SCOPE_DOT_SPACING       4     // Columns between dots on dotted traces
+
 //*****************************************************************************
 // Initialise OrbitOLED display.
 //*****************************************************************************
@@ -39,10 +48,12 @@ int16_t
 map(int16_t val, uint16_t min_in, uint16_t max_in, uint16_t min_out, uint16_t max_out);
 
 //*****************************************************************************
-// Function to map input ADC value to altitude range in percent.
+// Function to map input ADC value to altitude range in percent, given the ADC
+// value when landed and the change in ADC value from landed to full altitude.
+// Keeps the fraction of a percent for the altitude estimator.
 //*****************************************************************************
-int16_t
-mapAlt(uint16_t meanVal, uint16_t inADCMax);
+float
+mapAlt(uint16_t meanVal, uint16_t altZero, uint16_t altRange);
 
 //*****************************************************************************
 // Function to display the mean ADC value (10-bit value, note) and sample count.
@@ -54,7 +65,7 @@ displayMeanVal(int16_t mappedAlt, uint16_t desiredAlt);
 // Function to display the yaw value in degrees to display
 //*****************************************************************************
 void
-displayYaw(int16_t mappedYaw, int32_t desiredYaw);
+displayYaw(yawAngle_t yawAngle, int32_t desiredYaw);
 
 //*****************************************************************************
 // Function to display the PWM for main and tail rotors.
@@ -68,4 +79,24 @@ displayPWM(rotor_t *main, rotor_t *tail);
 void
 displayState(enum state heliState);
 
+//*****************************************************************************
+// Function to show altitude calibration is in progress and how many attempts
+// were rejected because the rig was moving.
+//*****************************************************************************
+void
+displayCalibrating(uint8_t rejects);
+
+//*****************************************************************************
+// Function to clear the display and reset the scope screen.
+//*****************************************************************************
+void
+displayClear(void);
+
+//*****************************************************************************
+// Function to add a sample to the scrolling altitude and yaw error scope.
+// Shifts the display one column left and only flushes pages that changed.
+//*****************************************************************************
+void
+displayScope(int16_t mappedAlt, int16_t desiredAlt, int16_t yawError);
+
 #endif /*DISPLAY_H_*/
@@ -0,0 +1,250 @@
+// *******************************************************
+//
+// filter.c
+//
+// Fixed point low pass filter pipeline. A cascade of biquad
+// sections with Q30 coefficients and 64 bit accumulation,
+// followed by optional decimation. Coefficients are designed
+// from a cutoff frequency and Butterworth order. An optional
+// spike rejection stage can be run ahead of the filter.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "filter.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define COEF_ONE            ((float) (1UL << FILTER_COEF_SHIFT))
+#define NOISE_GAIN_SAMPLES  2000    // Impulse response length summed for noise gain
+#define NOISE_GAIN_IMPULSE  4096    // Impulse size in input units
+#define SORT2(a, b)         if ((a) > (b)) { int32_t t = (a); (a) = (b); (b) = t; }
+
+//*****************************************************************************
+// runBiquad - One direct form I step. The products are summed in 64 bits,
+// which compiles to multiply accumulate long (SMLAL) on the Cortex-M4.
+//*****************************************************************************
+static inline int32_t
+runBiquad (biquad_t *bq, int32_t x)
+{
+    int64_t acc = (int64_t) bq->b0 * x;
+    acc += (int64_t) bq->b1 * bq->x1;
+    acc += (int64_t) bq->b2 * bq->x2;
+    acc += (int64_t) bq->a1 * bq->y1;
+    acc += (int64_t) bq->a2 * bq->y2;
+
+    int32_t y = (int32_t) ((acc + (1LL << (FILTER_COEF_SHIFT - 1))) >> FILTER_COEF_SHIFT);
+
+    bq->x2 = bq->x1;
+    bq->x1 = x;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+
+//*****************************************************************************
+// initLowPass - Designs a Butterworth low pass filter as a cascade of second
+// order sections using the bilinear transform with prewarping.
+//*****************************************************************************
+void
+initLowPass (filter_t *filter, float cutoffHz, float sampleHz, uint8_t order, uint8_t decimate)
+{
+    float K;
+    uint8_t i;
+
+    if (cutoffHz < FILTER_MIN_CUTOFF * sampleHz)
+    {
+        cutoffHz = FILTER_MIN_CUTOFF * sampleHz;
+    }
+    K = tanf (3.14159265f * cutoffHz / sampleHz);
+
+    filter->numStages = (order + 1) / 2;
+    if (filter->numStages > FILTER_MAX_STAGES)
+    {
+        filter->numStages = FILTER_MAX_STAGES;
+    }
+
+    // Each section has a pair of poles with its own Q.
+    for (i = 0; i < filter->numStages; i++)
+    {
+        biquad_t *bq = &filter->stage[i];
+        uint8_t n = 2 * filter->numStages;
+        float Q = 1 / (2 * cosf (3.14159265f * (2 * i + 1) / (2 * n)));
+        float norm = 1 / (1 + K / Q + K * K);
+
+        // a1 is near 2 and a2 near -1 at low cutoffs, where a float holds too
+        // few bits of them, so only their small distances from 2 and -1 are
+        // found in float. a1 = 2 - 2 (K/Q) norm - 4 K^2 norm and a2 = -1 +
+        // 2 (K/Q) norm, so with b0 = K^2 norm the DC gain is exactly one.
+        int32_t b0 = (int32_t) (K * K * norm * COEF_ONE + 0.5f);
+        int32_t e2 = (int32_t) (2 * K / Q * norm * COEF_ONE + 0.5f);
+
+        bq->b0 = b0;
+        bq->b1 = 2 * b0;
+        bq->b2 = b0;
+        bq->a1 = (int32_t) ((2LL << FILTER_COEF_SHIFT) - e2 - 4LL * b0);
+        bq->a2 = e2 - (1L << FILTER_COEF_SHIFT);
+    }
+
+    filter->decimate = (decimate > 0) ? decimate : 1;
+    filter->count = 0;
+    filter->primed = false;
+    filter->out = 0;
+}
+
+//*****************************************************************************
+// resetFilter - Sets the filter state as if sample had been input forever.
+//*****************************************************************************
+void
+resetFilter (filter_t *filter, int32_t sample)
+{
+    int32_t x = sample << FILTER_IN_SHIFT;
+    uint8_t i;
+
+    // Unity DC gain, so every section sits at the same value.
+    for (i = 0; i < filter->numStages; i++)
+    {
+        biquad_t *bq = &filter->stage[i];
+        bq->x1 = bq->x2 = x;
+        bq->y1 = bq->y2 = x;
+    }
+    filter->count = 0;
+    filter->out = x;
+    filter->primed = true;
+}
+
+//*****************************************************************************
+// filterSample - Filters one sample. Returns true when a new decimated output
+// is ready.
+//*****************************************************************************
+bool
+filterSample (filter_t *filter, int32_t sample)
+{
+    int32_t y = sample << FILTER_IN_SHIFT;
+    uint8_t i;
+
+    if (!filter->primed)
+    {
+        resetFilter (filter, sample);
+    }
+
+    for (i = 0; i < filter->numStages; i++)
+    {
+        y = runBiquad (&filter->stage[i], y);
+    }
+
+    if (++filter->count >= filter->decimate)
+    {
+        filter->count = 0;
+        filter->out = y;
+        return true;
+    }
+    return false;
+}
+
+//*****************************************************************************
+// getFilterOut - Returns the latest output, rounded to input units.
+//*****************************************************************************
+int32_t
+getFilterOut (const filter_t *filter)
+{
+    return (filter->out + (1 << (FILTER_IN_SHIFT - 1))) >> FILTER_IN_SHIFT;
+}
+
+//*****************************************************************************
+// filterNoiseGain - Returns the ratio of output to input standard deviation
+// for white noise, the root sum of squares of the impulse response.
+//*****************************************************************************
+float
+filterNoiseGain (const filter_t *filter)
+{
+    filter_t copy = *filter;
+    float sumSq = 0;
+    uint16_t n;
+    uint8_t i;
+
+    // Run an impulse through a copy of the filter from rest.
+    for (i = 0; i < copy.numStages; i++)
+    {
+        copy.stage[i].x1 = copy.stage[i].x2 = 0;
+        copy.stage[i].y1 = copy.stage[i].y2 = 0;
+    }
+    for (n = 0; n < NOISE_GAIN_SAMPLES; n++)
+    {
+        int32_t y = (n == 0) ? NOISE_GAIN_IMPULSE << FILTER_IN_SHIFT : 0;
+        for (i = 0; i < copy.numStages; i++)
+        {
+            y = runBiquad (&copy.stage[i], y);
+        }
+        float h = (float) y / ((float) NOISE_GAIN_IMPULSE * (1UL << FILTER_IN_SHIFT));
+        sumSq += h * h;
+    }
+    return sqrtf (sumSq);
+}
+
+//*****************************************************************************
+// initSpikeFilter - Empties the spike filter and sets its threshold in input
+// units. A threshold of 0 passes every sample through.
+//*****************************************************************************
+void
+initSpikeFilter (spikeFilter_t *spike, int32_t threshold)
+{
+    spike->index = 0;
+    spike->filled = 0;
+    spike->threshold = threshold;
+    spike->rejects = 0;
+}
+
+//*****************************************************************************
+// rejectSpikes - Returns sample, or the window median if sample is a spike.
+// The median of 5 is found with a 7 compare and swap network, so the time
+// taken does not depend on the data. Up to 2 spikes in the window are ignored.
+// Comparing the newest sample with the median adds no delay to good samples.
+//*****************************************************************************
+int32_t
+rejectSpikes (spikeFilter_t *spike, int32_t sample)
+{
+    int32_t p[SPIKE_WINDOW];
+    int32_t diff;
+    uint8_t i;
+
+    spike->window[spike->index] = sample;
+    spike->index = (spike->index + 1) % SPIKE_WINDOW;
+    if (spike->filled < SPIKE_WINDOW)
+    {
+        spike->filled++;
+    }
+    if (spike->filled < SPIKE_WINDOW || spike->threshold == 0)
+    {
+        return sample;
+    }
+
+    for (i = 0; i < SPIKE_WINDOW; i++)
+    {
+        p[i] = spike->window[i];
+    }
+    SORT2(p[0], p[1]);
+    SORT2(p[3], p[4]);
+    SORT2(p[0], p[3]);
+    SORT2(p[1], p[4]);
+    SORT2(p[1], p[2]);
+    SORT2(p[2], p[3]);
+    SORT2(p[1], p[2]);
+
+    diff = sample - p[2];
+    if (diff > spike->threshold || diff < -spike->threshold)
+    {
+        spike->rejects++;
+        return p[2];
+    }
+    return sample;
+}
@@ -0,0 +1,113 @@
+#ifndef FILTER_H_
+#define FILTER_H_
+
+// *******************************************************
+//
+// filter.h
+//
+// Fixed point low pass filter pipeline. A cascade of biquad
+// sections with Q30 coefficients and 64 bit accumulation,
+// followed by optional decimation. Coefficients are designed
+// from a cutoff frequency and Butterworth order. An optional
+// spike rejection stage can be run ahead of the filter.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define FILTER_MAX_STAGES   3       // Biquads in a filter, order up to 6
+#define FILTER_COEF_SHIFT   30      // Coefficients are Q30 so |a1| up to 2 fits
+#define FILTER_IN_SHIFT     16      // Samples are scaled up by 2^16 for resolution
+#define FILTER_MIN_CUTOFF   0.001f  // Lowest cutoff as a fraction of the sample rate
+#define SPIKE_WINDOW        5       // Samples in the spike rejection median
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+// Direct form I biquad. a1 and a2 are stored negated so every term is added.
+typedef struct {
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+    int32_t x1, x2;         // Previous inputs
+    int32_t y1, y2;         // Previous outputs
+} biquad_t;
+
+typedef struct {
+    biquad_t stage[FILTER_MAX_STAGES];
+    uint8_t numStages;
+    uint8_t decimate;       // Inputs per output
+    uint8_t count;          // Inputs since the last output
+    bool primed;            // False until the first sample sets the state
+    volatile int32_t out;   // Latest output, scaled by 2^FILTER_IN_SHIFT
+} filter_t;
+
+// Sliding median spike rejection. A sample further than threshold from the
+// median of the window, including itself, is replaced by the median.
+typedef struct {
+    int32_t window[SPIKE_WINDOW];
+    uint8_t index;          // Where the next sample goes
+    uint8_t filled;         // Samples in the window, up to SPIKE_WINDOW
+    int32_t threshold;      // Largest accepted distance from the median, 0 for off
+    volatile uint32_t rejects;  // Samples replaced so far
+} spikeFilter_t;
+
+//*****************************************************************************
+// initLowPass - Designs a Butterworth low pass filter of the given order
+// (rounded up to even) with cutoffHz at sampleHz, giving one output every
+// decimate samples. The cutoff is raised to at least FILTER_MIN_CUTOFF of
+// sampleHz. The state is set by the first sample filtered.
+//*****************************************************************************
+void
+initLowPass (filter_t *filter, float cutoffHz, float sampleHz, uint8_t order, uint8_t decimate);
+
+//*****************************************************************************
+// resetFilter - Sets the filter state as if sample had been input forever.
+//*****************************************************************************
+void
+resetFilter (filter_t *filter, int32_t sample);
+
+//*****************************************************************************
+// filterSample - Filters one sample. Returns true when a new decimated output
+// is ready. Short enough to call from an interrupt.
+//*****************************************************************************
+bool
+filterSample (filter_t *filter, int32_t sample);
+
+//*****************************************************************************
+// getFilterOut - Returns the latest output, rounded to input units.
+//*****************************************************************************
+int32_t
+getFilterOut (const filter_t *filter);
+
+//*****************************************************************************
+// filterNoiseGain - Returns the ratio of output to input standard deviation
+// for white noise, the root sum of squares of the impulse response.
+//*****************************************************************************
+float
+filterNoiseGain (const filter_t *filter);
+
+//*****************************************************************************
+// initSpikeFilter - Empties the spike filter and sets its threshold in input
+// units. A threshold of 0 passes every sample through.
+//*****************************************************************************
+void
+initSpikeFilter (spikeFilter_t *spike, int32_t threshold);
+
+//*****************************************************************************
+// rejectSpikes - Returns sample, or the window median if sample is a spike.
+// Short enough to call from an interrupt.
+//*****************************************************************************
+int32_t
+rejectSpikes (spikeFilter_t *spike, int32_t sample);
+
+#endif /* FILTER_H_ */
@@ -3,7 +3,10 @@
 // heliADC.c
 //
 // Initialisation files and interrupt handlers for ADC
-// sampling of an input.
+// sampling of the altitude, supply voltage and rotor
+// currents, all converted on one trigger of sequence 0.
+// The digital comparators watch the altitude for the
+// ground and the ceiling between controller updates.
 //
 // P.J. Bones UCECE
 // Last modified:   9.4.2019
@@ -20,32 +23,91 @@
 #include "driverlib/interrupt.h"
 #include "driverlib/adc.h"
 #include "heliADC.h"
+#include "filter.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static filter_t altFilter;
+static spikeFilter_t altSpike;
+static filter_t supplyFilter;
+static filter_t currentFilter[2];      // Indexed by MAIN and TAIL
+static void (*altLimitHandler)(enum altLimit limit) = 0;
+static uint32_t compHits = 0;           // Comparators that fired since the last sequence
+static uint8_t limitCount[NUM_ALT_LIMITS];
+static volatile uint32_t altSampleCount = 0;    // Altitude samples converted
+static volatile uint16_t altLastRaw = 0;        // Latest altitude sample before spike rejection
 
 
 //*****************************************************************************
-// The handler for the ADC conversion complete interrupt.
-// Writes to the circular buffer.
+// The handler for the ADC conversion complete and comparator interrupts.
+// Rejects spikes coupled in from the motor PWM, then writes the altitude to
+// the circular buffer and the altitude filter. Filters the other channels.
+// Calls the limit handler while the altitude is past a comparator limit.
 //*****************************************************************************
 void
 ADCIntHandler(void)
 {
+    uint32_t ulValues[ADC_SEQ_DEPTH];
     uint32_t ulValue;
+    uint32_t compStatus;
+    uint8_t limit;
+
+    //
+    // A comparator step can interrupt before the sequence is done, so note
+    // which fired and wait for the sequence to finish.
+    compStatus = ADCComparatorIntStatus(ADC0_BASE);
+    ADCComparatorIntClear(ADC0_BASE, compStatus);
+    compHits |= compStatus;
+    if (!ADCIntStatus(ADC0_BASE, ADC_SEQ, false))
+    {
+        return;
+    }
 
     //
-    // Get the single sample from ADC0.  ADC_BASE is defined in
+    // Count samples in a row past each limit, so a single spike is ignored.
+    for (limit = 0; limit < NUM_ALT_LIMITS; limit++)
+    {
+        if (!(compHits & (1 << limit)))
+        {
+            limitCount[limit] = 0;
+        }
+        else if (limitCount[limit] < ALT_LIMIT_SAMPLES)
+        {
+            limitCount[limit]++;
+        }
+        if (limitCount[limit] == ALT_LIMIT_SAMPLES && altLimitHandler)
+        {
+            altLimitHandler ((enum altLimit) limit);
+        }
+    }
+    compHits = 0;
+
+    //
+    // Get one sample of each channel from ADC0.  ADC_BASE is defined in
     // inc/hw_memmap.h
-    ADCSequenceDataGet(ADC0_BASE, 3, &ulValue);
+    ADCSequenceDataGet(ADC0_BASE, ADC_SEQ, ulValues);
+    filterSample (&supplyFilter, ulValues[ADC_STEP_SUPPLY]);
+    filterSample (&currentFilter[MAIN], ulValues[ADC_STEP_MAIN_CURRENT]);
+    filterSample (&currentFilter[TAIL], ulValues[ADC_STEP_TAIL_CURRENT]);
+    ulValue = ulValues[ADC_STEP_ALT];
+    altLastRaw = ulValue;
+    altSampleCount++;
+    //
+    // Replace the sample with the median of its neighbours if it is a spike
+    ulValue = rejectSpikes (&altSpike, ulValue);
     //
     // Place it in the circular buffer (advancing write index)
     writeCircBuf (&g_inBuffer, ulValue);
+    filterSample (&altFilter, ulValue);
     //
     // Clean up, clearing the interrupt
-    ADCIntClear(ADC0_BASE, 3);
+    ADCIntClear(ADC0_BASE, ADC_SEQ);
 }
 
 
 //********************************************************
-// initADC - Initialise ADC pins and sampling for sequence 3
+// initADC - Initialise ADC pins and sampling for sequence 0
 //********************************************************
 void
 initADC (void)
@@ -53,32 +115,189 @@ initADC (void)
     // The ADC0 peripheral must be enabled for configuration and use.
     SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
 
-    // Enable sample sequence 3 with a processor signal trigger.  Sequence 3
-    // will do a single sample when the processor sends a signal to start the
-    // conversion.
-    ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
+    // The supply and current inputs share port E with the altitude input.
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    GPIOPinTypeADC(GPIO_PORTE_BASE, ADC_AUX_GPIO_PINS);
+
+    // Enable sample sequence 0 with a processor signal trigger.  Sequence 0
+    // will do one sample of each of its steps when the processor sends a
+    // signal to start the conversion.
+    ADCSequenceConfigure(ADC0_BASE, ADC_SEQ, ADC_TRIGGER_PROCESSOR, 0);
 
     //
-    // Configure step 0 on sequence 3.  Sample channel 0 (ADC_CTL_CH9) in
-    // single-ended mode (PE4) and configure the interrupt flag
-    // (ADC_CTL_IE) to be set when the sample is done.  Tell the ADC logic
-    // that this is the last conversion on sequence 3 (ADC_CTL_END).  Sequence
-    // 3 has only one programmable step.  Sequence 1 and 2 have 4 steps, and
-    // sequence 0 has 8 programmable steps.  Since we are only doing a single
-    // conversion using sequence 3 we will only configure step 0.  For more
-    // on the ADC sequences and steps, refer to the LM3S1968 datasheet.
-    ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH9 | ADC_CTL_IE |
-                             ADC_CTL_END);
+    // Configure 6 steps of sequence 0 in single-ended mode: the altitude
+    // (ADC_CTL_CH9, PE4), then the supply voltage and the main and tail rotor
+    // currents, then the altitude to each comparator.  The interrupt flag
+    // (ADC_CTL_IE) is set when the last step (ADC_CTL_END) is done, so every
+    // channel is ready in the FIFO together.
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_ALT, ADC_CTL_CH9);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_SUPPLY, ADC_CTL_CH0);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_MAIN_CURRENT, ADC_CTL_CH1);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_TAIL_CURRENT, ADC_CTL_CH2);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_GROUND, ADC_CTL_CH9 | ADC_CTL_CMP0);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQ, ADC_STEP_CEILING, ADC_CTL_CH9 | ADC_CTL_CMP1 |
+                             ADC_CTL_IE | ADC_CTL_END);
 
     //
-    // Since sample sequence 3 is now configured, it must be enabled.
-    ADCSequenceEnable(ADC0_BASE, 3);
+    // The comparators stay quiet until setAltLimits gives them limits.
+    ADCComparatorConfigure(ADC0_BASE, ALT_LIMIT_GROUND, ADC_COMP_TRIG_NONE);
+    ADCComparatorConfigure(ADC0_BASE, ALT_LIMIT_CEILING, ADC_COMP_TRIG_NONE);
+
+    //
+    // Since sample sequence 0 is now configured, it must be enabled.
+    ADCSequenceEnable(ADC0_BASE, ADC_SEQ);
 
     //
     // Register the interrupt handler
-    ADCIntRegister (ADC0_BASE, 3, ADCIntHandler);
+    ADCIntRegister (ADC0_BASE, ADC_SEQ, ADCIntHandler);
 
     //
-    // Enable interrupts for ADC0 sequence 3 (clears any outstanding interrupts)
-    ADCIntEnable(ADC0_BASE, 3);
+    // Enable interrupts for ADC0 sequence 0 and its comparators (clears any
+    // outstanding interrupts)
+    ADCIntEnable(ADC0_BASE, ADC_SEQ);
+    ADCComparatorIntEnable(ADC0_BASE, ADC_SEQ);
+}
+
+//*****************************************************************************
+// initAltFilter - Designs the altitude, supply and current filters for samples
+// at sampleRate Hz.
+//*****************************************************************************
+void
+initAltFilter (uint32_t sampleRate)
+{
+    initSpikeFilter (&altSpike, ALT_SPIKE_THRESHOLD);
+    initLowPass (&altFilter, ALT_FILTER_CUTOFF_HZ, sampleRate, ALT_FILTER_ORDER,
+                 ALT_FILTER_DECIMATE);
+    initLowPass (&supplyFilter, AUX_FILTER_CUTOFF_HZ, sampleRate, AUX_FILTER_ORDER,
+                 ALT_FILTER_DECIMATE);
+    initLowPass (&currentFilter[MAIN], AUX_FILTER_CUTOFF_HZ, sampleRate, AUX_FILTER_ORDER,
+                 ALT_FILTER_DECIMATE);
+    initLowPass (&currentFilter[TAIL], AUX_FILTER_CUTOFF_HZ, sampleRate, AUX_FILTER_ORDER,
+                 ALT_FILTER_DECIMATE);
+}
+
+//*****************************************************************************
+// getAltFiltered - Returns the latest filtered altitude in ADC counts.
+//*****************************************************************************
+uint16_t
+getAltFiltered (void)
+{
+    return getFilterOut (&altFilter);
+}
+
+//*****************************************************************************
+// setAltSpikeThreshold - Sets the largest accepted step of a sample from the
+// median of its neighbours in ADC counts, 0 to turn spike rejection off.
+//*****************************************************************************
+void
+setAltSpikeThreshold (int32_t threshold)
+{
+    altSpike.threshold = threshold;
+}
+
+//*****************************************************************************
+// getAltSpikeThreshold - Returns the spike rejection threshold in ADC counts.
+//*****************************************************************************
+int32_t
+getAltSpikeThreshold (void)
+{
+    return altSpike.threshold;
+}
+
+//*****************************************************************************
+// getAltSpikes - Returns the number of altitude samples rejected as spikes.
+//*****************************************************************************
+uint32_t
+getAltSpikes (void)
+{
+    return altSpike.rejects;
+}
+
+//*****************************************************************************
+// getAltNoiseGain - Returns the ratio of filtered to raw altitude noise.
+//*****************************************************************************
+float
+getAltNoiseGain (void)
+{
+    return filterNoiseGain (&altFilter);
+}
+
+//*****************************************************************************
+// getSupplyMv - Returns the filtered supply voltage in mV.
+//*****************************************************************************
+uint32_t
+getSupplyMv (void)
+{
+    return (uint32_t) getFilterOut (&supplyFilter) * ADC_FULL_SCALE_MV * SUPPLY_DIVIDER /
+           ADC_FULL_SCALE_COUNTS;
+}
+
+//*****************************************************************************
+// getRotorCurrent - Returns the filtered current of the MAIN or TAIL rotor
+// in mA.
+//*****************************************************************************
+uint32_t
+getRotorCurrent (enum motor motor)
+{
+    // Rounding in the filter can take a reading near zero just below it.
+    int32_t counts = getFilterOut (&currentFilter[motor]);
+
+    if (counts < 0)
+    {
+        counts = 0;
+    }
+    return (uint32_t) counts * ADC_FULL_SCALE_MV * CURRENT_MA_PER_MV / ADC_FULL_SCALE_COUNTS;
+}
+
+//*****************************************************************************
+// setAltLimits - Sets the comparators to watch for the altitude reaching the
+// ground, ADC readings above groundCounts, or passing the ceiling, readings
+// below ceilingCounts. Each limit is cleared once the reading is hystCounts
+// back inside it.
+//*****************************************************************************
+void
+setAltLimits (uint16_t groundCounts, uint16_t ceilingCounts, uint16_t hystCounts)
+{
+    // The altitude reading falls as the heli climbs, so the ground is the
+    // high band of comparator 0 and the ceiling the low band of comparator 1.
+    // Hysteresis modes keep each limit set in the mid band once reached.
+    ADCComparatorRegionSet(ADC0_BASE, ALT_LIMIT_GROUND,
+                           groundCounts > hystCounts ? groundCounts - hystCounts : 0,
+                           groundCounts);
+    ADCComparatorRegionSet(ADC0_BASE, ALT_LIMIT_CEILING, ceilingCounts,
+                           ceilingCounts + hystCounts);
+    ADCComparatorReset(ADC0_BASE, ALT_LIMIT_GROUND, true, true);
+    ADCComparatorReset(ADC0_BASE, ALT_LIMIT_CEILING, true, true);
+    ADCComparatorConfigure(ADC0_BASE, ALT_LIMIT_GROUND,
+                           ADC_COMP_TRIG_NONE | ADC_COMP_INT_HIGH_HALWAYS);
+    ADCComparatorConfigure(ADC0_BASE, ALT_LIMIT_CEILING,
+                           ADC_COMP_TRIG_NONE | ADC_COMP_INT_LOW_HALWAYS);
+}
+
+//*****************************************************************************
+// setAltLimitHandler - Sets the function called from the ADC interrupt for
+// every sample once a limit has been past for ALT_LIMIT_SAMPLES.
+//*****************************************************************************
+void
+setAltLimitHandler (void (*handler)(enum altLimit limit))
+{
+    altLimitHandler = handler;
+}
+
+//*****************************************************************************
+// getAltSampleCount - Returns the number of altitude samples converted.
+//*****************************************************************************
+uint32_t
+getAltSampleCount (void)
+{
+    return altSampleCount;
+}
+
+//*****************************************************************************
+// getAltRaw - Returns the latest altitude sample before spike rejection.
+//*****************************************************************************
+uint16_t
+getAltRaw (void)
+{
+    return altLastRaw;
 }
@@ -6,7 +6,10 @@
 // heliADC.h
 //
 // Initialisation files and interrupt handlers for ADC
-// sampling of an input.
+// sampling of the altitude, supply voltage and rotor
+// currents, all converted on one trigger of sequence 0.
+// The digital comparators watch the altitude for the
+// ground and the ceiling between controller updates.
 //
 // P.J. Bones UCECE
 // Last modified:   9.4.2019
@@ -18,7 +21,46 @@
 #include "driverlib/gpio.h"
 #include "driverlib/adc.h"
 #include "circBufT.h"
+#include "filter.h"
+#include "heliPWM.h"
 
+// ****************************************************************************
+// Constants
+// ****************************************************************************
+#define ALT_FILTER_CUTOFF_HZ    25      // Altitude anti-alias cutoff, the estimator smooths further
+#define ALT_FILTER_ORDER        2       // Butterworth order of altitude filter
+#define ALT_FILTER_DECIMATE     10      // Samples per filtered altitude output
+#define ALT_SPIKE_THRESHOLD     60      // Largest step from the median in ADC counts, 0 for off
+
+//---Sequence 0 converts every channel on one trigger, altitude first. The
+//   comparator steps sample the altitude again, as a step sent to a
+//   comparator does not write to the FIFO.
+#define ADC_SEQ                 0
+#define ADC_SEQ_DEPTH           8       // FIFO entries in sequence 0
+#define ADC_STEP_ALT            0       // PE4, AIN9
+#define ADC_STEP_SUPPLY         1       // PE3, AIN0
+#define ADC_STEP_MAIN_CURRENT   2       // PE2, AIN1
+#define ADC_STEP_TAIL_CURRENT   3       // PE1, AIN2
+#define ADC_STEP_GROUND         4       // PE4, AIN9 to comparator 0
+#define ADC_STEP_CEILING        5       // PE4, AIN9 to comparator 1
+#define ADC_AUX_GPIO_PINS       (GPIO_PIN_3 | GPIO_PIN_2 | GPIO_PIN_1)
+
+//---Supply and current scaling
+#define ADC_FULL_SCALE_MV       3300    // Input at full scale
+#define ADC_FULL_SCALE_COUNTS   4096
+#define SUPPLY_DIVIDER          6       // Supply volts per volt at the ADC input
+#define CURRENT_MA_PER_MV       1       // Sense amplifier output, mA per mV at the input
+#define AUX_FILTER_CUTOFF_HZ    5       // Supply and current low pass cutoff frequency
+#define AUX_FILTER_ORDER        2
+
+//---Altitude limit comparators
+#define ALT_LIMIT_SAMPLES       3       // Samples in a row past a limit before it is acted on
+
+
+// ****************************************************************************
+// Types
+// ****************************************************************************
+enum altLimit {ALT_LIMIT_GROUND = 0, ALT_LIMIT_CEILING, NUM_ALT_LIMITS};   // By comparator
 
 // ****************************************************************************
 // Globals to module
@@ -34,9 +76,88 @@ ADCIntHandler(void);
 
 
 //*****************************************************************************
-// initADC - Initialise ADC pins and sampling for sequence 3
+// initADC - Initialise ADC pins and sampling for sequence 0
 //*****************************************************************************
 void
 initADC (void);
 
+//*****************************************************************************
+// initAltFilter - Designs the altitude, supply and current filters for samples
+// at sampleRate Hz. Call before the ADC is first triggered.
+//*****************************************************************************
+void
+initAltFilter (uint32_t sampleRate);
+
+//*****************************************************************************
+// getAltFiltered - Returns the latest filtered altitude in ADC counts.
+//*****************************************************************************
+uint16_t
+getAltFiltered (void);
+
+//*****************************************************************************
+// setAltSpikeThreshold - Sets the largest accepted step of a sample from the
+// median of its neighbours in ADC counts, 0 to turn spike rejection off.
+//*****************************************************************************
+void
+setAltSpikeThreshold (int32_t threshold);
+
+//*****************************************************************************
+// getAltSpikeThreshold - Returns the spike rejection threshold in ADC counts.
+//*****************************************************************************
+int32_t
+getAltSpikeThreshold (void);
+
+//*****************************************************************************
+// getAltSpikes - Returns the number of altitude samples rejected as spikes.
+//*****************************************************************************
+uint32_t
+getAltSpikes (void);
+
+//*****************************************************************************
+// getAltNoiseGain - Returns the ratio of filtered to raw altitude noise.
+//*****************************************************************************
+float
+getAltNoiseGain (void);
+
+//*****************************************************************************
+// getSupplyMv - Returns the filtered supply voltage in mV.
+//*****************************************************************************
+uint32_t
+getSupplyMv (void);
+
+//*****************************************************************************
+// getRotorCurrent - Returns the filtered current of the MAIN or TAIL rotor
+// in mA.
+//*****************************************************************************
+uint32_t
+getRotorCurrent (enum motor motor);
+
+//*****************************************************************************
+// setAltLimits - Sets the comparators to watch for the altitude reaching the
+// ground, ADC readings above groundCounts, or passing the ceiling, readings
+// below ceilingCounts. Each limit is cleared once the reading is hystCounts
+// back inside it.
+//*****************************************************************************
+void
+setAltLimits (uint16_t groundCounts, uint16_t ceilingCounts, uint16_t hystCounts);
+
+//*****************************************************************************
+// setAltLimitHandler - Sets the function called from the ADC interrupt for
+// every sample once a limit has been past for ALT_LIMIT_SAMPLES.
+//*****************************************************************************
+void
+setAltLimitHandler (void (*handler)(enum altLimit limit));
+
+//*****************************************************************************
+// getAltSampleCount - Returns the number of altitude samples converted.
+//*****************************************************************************
+uint32_t
+getAltSampleCount (void);
+
+//*****************************************************************************
+// getAltRaw - Returns the latest altitude sample before spike rejection.
+//*****************************************************************************
+uint16_t
+getAltRaw (void);
+
 #endif /*HELIADC_H_*/
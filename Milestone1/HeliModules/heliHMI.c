@@ -14,6 +14,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
 #include "heliHMI.h"
 #include "utils/ustdlib.h"
 #include "USBUART.h"
@@ -21,6 +23,33 @@
 #include "heliPWM.h"
 #include "stateMachine.h"
 #include "yaw.h"
+#include "motorControl.h"
+#include "tailCal.h"
+#include "autotune.h"
+#include "altEstimator.h"
+#include "heliADC.h"
+#include "motorOutput.h"
+#include "heliHealth.h"
+#include "mission.h"
+#include "buttons4.h"
+
+//********************************************************
+// clampField - Returns value as an integer limited to
+// +-FIELD_MAX, so it prints in at most 6 characters.
+//********************************************************
+static int32_t
+clampField (float value)
+{
+    if (value > FIELD_MAX)
+    {
+        return FIELD_MAX;
+    }
+    if (value < -FIELD_MAX)
+    {
+        return -FIELD_MAX;
+    }
+    return (int32_t) value;
+}
 
 //********************************************************
 // handleHMI - Handle output to UART port and display.
@@ -28,14 +57,30 @@
 void
 handleHMI (heli_t *heli)
 {
+    static enum dispMode prevDispMode = TEXT_DISP;
+
     // Output data to UART
     handleUART (heli);
 
-    // Update OLED display with ADC, yaw value, duty cycles and state.
-    displayMeanVal (heli->mappedAlt, heli->desiredAlt);
-    displayYaw (heli->mappedYaw, heli->desiredYaw);
-    displayPWM (heli->mainRotor, heli->tailRotor);
-    displayState (heli->heliState);
+    // Clear leftover text or traces when display mode changes.
+    if (heli->dispMode != prevDispMode)
+    {
+        displayClear ();
+        prevDispMode = heli->dispMode;
+    }
+
+    if (heli->dispMode == SCOPE_DISP)
+    {
+        // Scroll altitude, desired altitude and yaw error across the OLED.
+        displayScope (heli->mappedAlt, heli->desiredAlt,
+                      YAW_ANGLE2DEG ((yawAngle_t) (YAW_DEG2ANGLE (heli->desiredYaw) - heli->yawAngle)));
+    } else {
+        // Update OLED display with ADC, yaw value, duty cycles and state.
+        displayMeanVal (heli->mappedAlt, heli->desiredAlt);
+        displayYaw (heli->yawAngle, heli->desiredYaw);
+        displayPWM (heli->mainRotor, heli->tailRotor);
+        displayState (heli->heliState);
+    }
 }
 
 //********************************************************
@@ -52,23 +97,139 @@ handleUART (heli_t *heli)
 
     // Form and send a status message for yaw to the console
     int16_t mappedDesiredYaw = mapYaw2Deg (heli->desiredYaw, true);
-    usnprintf (statusStr, sizeof(statusStr), "YAW: %3d [%3d]\r\n",
-               heli->mappedYaw, mappedDesiredYaw);
+    int16_t yawDeciDeg = YAW_ANGLE2DDEG (heli->yawAngle);
+    char sign = (yawDeciDeg < 0) ? '-' : ' ';
+    yawDeciDeg = abs (yawDeciDeg);
+    usnprintf (statusStr, sizeof(statusStr), "YAW:%c%3d.%d [%4d]\r\n",
+               sign, yawDeciDeg / 10, yawDeciDeg % 10, mappedDesiredYaw);
     UARTSend (statusStr);
 
     // Form and send a status message for rotor duty cycles
     if (heli->mainRotor->state && heli->tailRotor->state)
     {
         usnprintf (statusStr, sizeof(statusStr), "MAIN %2d TAIL %2d\r\n",
-                   heli->mainRotor->duty, heli->tailRotor->duty);
+                   DUTY_Q162PER (heli->mainRotor->duty), DUTY_Q162PER (heli->tailRotor->duty));
     } else {
         usnprintf (statusStr, sizeof(statusStr), "MAIN %2d TAIL %2d\r\n", 0, 0);
     }
     UARTSend (statusStr);
 
+    // Send one diagnostic line per update, cycling through them so the
+    // UART is not overloaded.
+    static uint8_t diagLine = 0;
+    switch (diagLine)
+    {
+    case 0:     // Number of illegal yaw encoder transitions
+        usnprintf (statusStr, sizeof(statusStr), "ENC ERR: %5d\r\n", getYawIllegalCount ());
+        break;
+    case 1:     // Yaw rate in deg/s
+        usnprintf (statusStr, sizeof(statusStr), "YAW RATE: %4d\r\n", (int32_t) getYawRate ());
+        break;
+    case 2:     // Tail feedforward gain and offset in hundredths, or calibrating
+        if (tailCalRunning ())
+        {
+            usnprintf (statusStr, sizeof(statusStr), "FF: CALIBRATING\r\n");
+        } else {
+            float gain, offset, rateGain;
+            getTailFeedforward (&gain, &offset, &rateGain);
+            usnprintf (statusStr, sizeof(statusStr), "FF: %4d %4d\r\n",
+                       (int32_t) (gain * 100), (int32_t) (offset * 100));
+        }
+        break;
+    case 3:     // Autotune axis, ultimate gain in hundredths and period in ms
+    {
+        const tuneResult_t *tune = getAutotuneResult ();
+        usnprintf (statusStr, sizeof(statusStr), "TUNE %c %4d %5d\r\n",
+                   (tune->axis == AXIS_ALT) ? 'A' : 'Y',
+                   clampField (tune->Ku * 100), clampField (tune->Pu * 1000));
+        break;
+    }
+    case 4:     // Autotuned gains in hundredths, or progress while running
+    {
+        const tuneResult_t *tune = getAutotuneResult ();
+        if (tune->status == TUNE_RUNNING)
+        {
+            usnprintf (statusStr, sizeof(statusStr), "TUNE CYCLE %2d\r\n", tune->cycles);
+        } else {
+            usnprintf (statusStr, sizeof(statusStr), "G%4d %4d %4d\r\n",
+                       clampField (tune->gains.Kp * 100), clampField (tune->gains.Ki * 100),
+                       clampField (tune->gains.Kd * 100));
+        }
+        break;
+    }
+    case 5:     // Estimated altitude and climb rate in tenths, altitude SD in hundredths
+    {
+        const altEst_t *est = getAltEst ();
+        usnprintf (statusStr, sizeof(statusStr), "EST %4d %4d %3d\r\n",
+                   clampField (est->x[EST_ALT] * 10), clampField (est->x[EST_VEL] * 10),
+                   clampField (sqrtf (est->P[EST_ALT][EST_ALT]) * 100));
+        break;
+    }
+    case 6:     // Number of altitude samples rejected as spikes
+        usnprintf (statusStr, sizeof(statusStr), "SPIKES: %6d\r\n", getAltSpikes ());
+        break;
+    case 7:     // Supply in tenths of a volt, main and tail current in mA and fault
+        usnprintf (statusStr, sizeof(statusStr), "P%3d %4d%c %4d%c\r\n", getSupplyMv () / 100,
+                   getRotorCurrent (MAIN), ROTOR_FAULT_CHARS[heli->mainRotor->fault],
+                   getRotorCurrent (TAIL), ROTOR_FAULT_CHARS[heli->tailRotor->fault]);
+        break;
+    case 8:     // Sensor faults raised: ADC stuck, ADC rate, yaw steps, yaw reference
+        usnprintf (statusStr, sizeof(statusStr), "H%3d %3d %3d %3d\r\n",
+                   getHealthCount (HEALTH_ADC_STUCK), getHealthCount (HEALTH_ADC_RATE),
+                   getHealthCount (HEALTH_YAW_EDGES), getHealthCount (HEALTH_YAW_REF));
+        break;
+    case 9:     // Button events lost to a full queue
+        usnprintf (statusStr, sizeof(statusStr), "BUT DROP: %5d\r\n", getButtonEventsDropped ());
+        break;
+    }
+    UARTSend (statusStr);
+    diagLine = (diagLine + 1) % NUM_DIAG_LINES;
+
+    // Send at most one log line per update, taking turns between the logs
+    // so neither holds up the other. At BAUD_RATE one such line fits in
+    // each update alongside the status lines. A log with nothing new passes
+    // its turn to the next.
+    static uint8_t logLine = 0;
+    uint8_t tries;
+    for (tries = 0; tries < NUM_LOG_LINES; tries++)
+    {
+        bool formed = false;
+        switch (logLine)
+        {
+        case 0:     // Oldest state transition not yet sent: time in ms, from
+        {           // and to states and the transition table row taken
+            stateLog_t entry;
+            formed = takeStateLog (&entry);
+            if (formed)
+            {
+                usnprintf (statusStr, sizeof(statusStr), "TR%7d %d>%d #%2d\r\n", entry.timeMs,
+                           entry.from, entry.to, entry.rule);
+            }
+            break;
+        }
+        case 1:     // Oldest mission waypoint result not yet sent: waypoint,
+        {           // settle time and time in tolerance in ms
+            wpResult_t result;
+            formed = takeMissionResult (&result);
+            if (formed)
+            {
+                usnprintf (statusStr, sizeof(statusStr), "WP%2d %5d %5d\r\n", result.index,
+                           result.settleMs, result.inTolMs);
+            }
+            break;
+        }
+        }
+        logLine = (logLine + 1) % NUM_LOG_LINES;
+        if (formed)
+        {
+            UARTSend (statusStr);
+            break;
+        }
+    }
+
     // Send status message about helicopter state
-    char *state[] = {"LANDED", "TAKE OFF", "FLYING", "LANDING", "ERROR"};
+    char *state[] = {"LANDED", "TAKE OFF", "FLYING", "LANDING", "AUTOTUNE", "MISSION", "ERROR"};
     // Leave enough space for the template, state and null terminator.
-    usnprintf (statusStr, sizeof(statusStr), "HELI: %s\r\n\n", state[heliState]);
+    usnprintf (statusStr, sizeof(statusStr), "HELI: %s\r\n\n", state[heli->heliState]);
     UARTSend (statusStr);
 }
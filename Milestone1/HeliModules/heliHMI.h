@@ -23,7 +23,11 @@
 //*****************************************************************************
 // Constants
 //*****************************************************************************
-#define MAX_STR_LEN         17
+#define MAX_STR_LEN         26      // Longest line, H with 5 digit counts or EST at FIELD_MAX
+#define FIELD_MAX           99999   // Largest magnitude printed from a float
+#define NUM_DIAG_LINES      10      // Diagnostic lines sent in turn, one per update
+#define NUM_LOG_LINES       2       // Logs sent in turn, at most one line per update
+#define ROTOR_FAULT_CHARS   " OS"   // Telemetry flag for each rotorFault
 
 //********************************************************
 // handleHMI - Handle output to UART port and display.
@@ -0,0 +1,184 @@
+// *******************************************************
+//
+// heliHealth.c
+//
+// Sensor health monitor. Checks the altitude ADC is still
+// converting and is not stuck, that the yaw encoder steps
+// while the tail rotor is turning the heli, and that the yaw
+// reference is found in time. Works only on the inputs it is
+// given so it does not depend on the hardware.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "heliHealth.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define MS2UPDATES(T)       ((uint32_t) (T) * HEALTH_UPDATE_RATE / 1000)
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static uint32_t faults;
+static uint16_t faultCount[NUM_HEALTH_FAULTS];
+
+// ADC checks, over a window of updates
+static uint16_t adcUpdates;
+static uint32_t adcWindowSamples;   // Sample count at the start of the window
+static uint16_t adcFirst;           // First sample in the window, removed before summing
+static int32_t adcSum;
+static int64_t adcSumSq;
+
+// Yaw checks
+static uint32_t lastEdges;
+static uint32_t edgeUpdates;        // Updates rotating since the last step
+static bool wasFindingRef;
+static uint32_t refEdges;           // Steps when the reference search started
+static uint32_t refUpdates;         // Updates searching for the reference
+
+//*****************************************************************************
+// setFault - Sets or clears fault, counting each time it is raised.
+//*****************************************************************************
+static void
+setFault (enum healthFault fault, bool present)
+{
+    uint32_t bit = HEALTH_FAULT_BIT(fault);
+
+    if (present && !(faults & bit))
+    {
+        faultCount[fault]++;
+        faults |= bit;
+    }
+    else if (!present)
+    {
+        faults &= ~bit;
+    }
+}
+
+//*****************************************************************************
+// checkAdc - Finds the variance and rate of the altitude samples once a window
+// of updates is collected. A converter that stops or freezes gives neither
+// the expected rate nor any noise.
+//*****************************************************************************
+static void
+checkAdc (const healthInput_t *in)
+{
+    int32_t diff;
+
+    if (adcUpdates == 0)
+    {
+        adcWindowSamples = in->adcSamples;
+        adcFirst = in->adcRaw;
+        adcSum = 0;
+        adcSumSq = 0;
+    }
+
+    diff = (int32_t) in->adcRaw - adcFirst;
+    adcSum += diff;
+    adcSumSq += diff * diff;
+
+    if (++adcUpdates < HEALTH_ADC_WINDOW)
+    {
+        return;
+    }
+
+    float mean = (float) adcSum / adcUpdates;
+    float variance = (float) adcSumSq / adcUpdates - mean * mean;
+    uint32_t samples = in->adcSamples - adcWindowSamples;
+
+    setFault (HEALTH_ADC_STUCK, variance < HEALTH_ADC_MIN_VAR);
+    setFault (HEALTH_ADC_RATE, samples < (uint32_t) HEALTH_ADC_MIN_RATE * (HEALTH_ADC_WINDOW - 1) /
+                               HEALTH_UPDATE_RATE);
+    adcUpdates = 0;
+}
+
+//*****************************************************************************
+// checkYaw - Checks the encoder steps while rotating, and that the reference
+// is found within a time and number of steps.
+//*****************************************************************************
+static void
+checkYaw (const healthInput_t *in)
+{
+    // Encoder must step while the tail rotor is turning the heli.
+    if (in->rotating && in->yawEdges == lastEdges)
+    {
+        edgeUpdates++;
+    } else {
+        edgeUpdates = 0;
+    }
+    lastEdges = in->yawEdges;
+    setFault (HEALTH_YAW_EDGES, edgeUpdates > MS2UPDATES(HEALTH_YAW_EDGE_MS));
+
+    // Reference must be found before turning too long or too far.
+    if (in->findingRef && !wasFindingRef)
+    {
+        refEdges = in->yawEdges;
+        refUpdates = 0;
+    }
+    wasFindingRef = in->findingRef;
+    if (in->findingRef)
+    {
+        refUpdates++;
+        setFault (HEALTH_YAW_REF, refUpdates > MS2UPDATES(HEALTH_REF_MS) ||
+                                  in->yawEdges - refEdges > HEALTH_REF_MAX_STEPS);
+    } else {
+        setFault (HEALTH_YAW_REF, false);
+    }
+}
+
+//*****************************************************************************
+// resetHealth - Clears all faults, counts and checks in progress.
+//*****************************************************************************
+void
+resetHealth (void)
+{
+    uint8_t i;
+
+    faults = 0;
+    for (i = 0; i < NUM_HEALTH_FAULTS; i++)
+    {
+        faultCount[i] = 0;
+    }
+    adcUpdates = 0;
+    edgeUpdates = 0;
+    wasFindingRef = false;
+}
+
+//*****************************************************************************
+// updateHealth - Runs the checks on one set of inputs. Call at
+// HEALTH_UPDATE_RATE. Returns the faults now present as HEALTH_FAULT_BITs.
+//*****************************************************************************
+uint32_t
+updateHealth (const healthInput_t *in)
+{
+    checkAdc (in);
+    checkYaw (in);
+    return faults;
+}
+
+//*****************************************************************************
+// getHealthFaults - Returns the faults now present as HEALTH_FAULT_BITs.
+//*****************************************************************************
+uint32_t
+getHealthFaults (void)
+{
+    return faults;
+}
+
+//*****************************************************************************
+// getHealthCount - Returns the number of times fault has been raised.
+//*****************************************************************************
+uint16_t
+getHealthCount (enum healthFault fault)
+{
+    return faultCount[fault];
+}
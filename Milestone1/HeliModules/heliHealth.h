@@ -0,0 +1,79 @@
+#ifndef HELIHEALTH_H_
+#define HELIHEALTH_H_
+
+// *******************************************************
+//
+// heliHealth.h
+//
+// Sensor health monitor. Checks the altitude ADC is still
+// converting and is not stuck, that the yaw encoder steps
+// while the tail rotor is turning the heli, and that the yaw
+// reference is found in time. Works only on the inputs it is
+// given so it does not depend on the hardware.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "yaw.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define HEALTH_UPDATE_RATE      100     // Rate updateHealth is called at in Hz
+#define HEALTH_ADC_WINDOW       100     // Updates the ADC checks are made over
+#define HEALTH_ADC_MIN_VAR      0.1f    // Least altitude sample variance in ADC counts^2
+#define HEALTH_ADC_MIN_RATE     500     // Least altitude sample rate in Hz
+#define HEALTH_YAW_EDGE_MS      2000    // Longest time rotating without a yaw step
+#define HEALTH_REF_MS           15000   // Longest time to find the yaw reference
+#define HEALTH_REF_MAX_STEPS    (2 * YAW_TABS)  // Most yaw steps to find the reference, 2 turns
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum healthFault {HEALTH_ADC_STUCK = 0, HEALTH_ADC_RATE, HEALTH_YAW_EDGES, HEALTH_YAW_REF,
+                  NUM_HEALTH_FAULTS};
+
+#define HEALTH_FAULT_BIT(F)     (1u << (F))
+#define HEALTH_ADC_FAULTS       (HEALTH_FAULT_BIT(HEALTH_ADC_STUCK) | HEALTH_FAULT_BIT(HEALTH_ADC_RATE))
+
+typedef struct {
+    uint32_t adcSamples;    // Altitude samples converted so far
+    uint16_t adcRaw;        // Latest altitude sample
+    uint32_t yawEdges;      // Yaw encoder steps so far, either direction
+    bool rotating;          // Tail rotor is set to turn the heli, steps are expected
+    bool findingRef;        // Waiting for the yaw reference
+} healthInput_t;
+
+//*****************************************************************************
+// resetHealth - Clears all faults, counts and checks in progress.
+//*****************************************************************************
+void
+resetHealth (void);
+
+//*****************************************************************************
+// updateHealth - Runs the checks on one set of inputs. Call at
+// HEALTH_UPDATE_RATE. Returns the faults now present as HEALTH_FAULT_BITs.
+//*****************************************************************************
+uint32_t
+updateHealth (const healthInput_t *in);
+
+//*****************************************************************************
+// getHealthFaults - Returns the faults now present as HEALTH_FAULT_BITs.
+//*****************************************************************************
+uint32_t
+getHealthFaults (void);
+
+//*****************************************************************************
+// getHealthCount - Returns the number of times fault has been raised.
+//*****************************************************************************
+uint16_t
+getHealthCount (enum healthFault fault);
+
+#endif /* HELIHEALTH_H_ */
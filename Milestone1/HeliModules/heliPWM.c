@@ -44,8 +44,9 @@ initPWMMain (rotor_t *rotor)
     // Set the initial PWM parameters
     rotor->type = MAIN;
     rotor->freq = PWM_MAIN_FREQ_HZ;
-    rotor->duty = PWM_START_DUTY_PER;
+    rotor->duty = DUTY_PER2Q16(PWM_START_DUTY_PER);
     rotor->state = false;
+    rotor->supplyComp = DUTY_Q16_ONE;
     setPWM (rotor);
 
     PWMGenEnable(PWM_MAIN_BASE, PWM_MAIN_GEN);
@@ -73,8 +74,9 @@ initPWMTail (rotor_t *rotor)
     // Set the initial PWM parameters
     rotor->type = TAIL;
     rotor->freq = PWM_TAIL_FREQ_HZ;
-    rotor->duty = PWM_START_DUTY_PER;
+    rotor->duty = DUTY_PER2Q16(PWM_START_DUTY_PER);
     rotor->state = false;
+    rotor->supplyComp = DUTY_Q16_ONE;
     setPWM (rotor);
 
     PWMGenEnable(PWM_TAIL_BASE, PWM_TAIL_GEN);
@@ -91,18 +93,47 @@ void
 setPWM (rotor_t *rotor)
 {
     // Calculate the PWM period corresponding to the freq.
-    uint32_t ui32Period = SysCtlClockGet() / PWM_DIVIDER / rotor->freq;
+    rotor->period = SysCtlClockGet() / PWM_DIVIDER / rotor->freq;
+
+    if (rotor->type == MAIN)
+    {
+        PWMGenPeriodSet(PWM_MAIN_BASE, PWM_MAIN_GEN, rotor->period);
+    } else if (rotor->type == TAIL)
+    {
+        PWMGenPeriodSet(PWM_TAIL_BASE, PWM_TAIL_GEN, rotor->period);
+    }
+    setDuty (rotor, rotor->duty);
+}
+
+/********************************************************
+ * Function to set only the duty cycle of a rotor, using the
+ * period calculated by setPWM. Only writes the compare register.
+ * Duty is a Q16 fraction of the period, giving a resolution
+ * of one timer tick. The pulse written is scaled by supplyComp
+ * and limited to PWM_DUTY_MAX_PER.
+ * Without global sync the compare register is updated when the
+ * counter next reaches zero, so a new duty takes effect at the
+ * start of the next period and never cuts a pulse short.
+ ********************************************************/
+void
+setDuty (rotor_t *rotor, uint32_t duty)
+{
+    uint32_t output = ((uint64_t) duty * rotor->supplyComp) >> 16;
+
+    rotor->duty = duty;
+    if (output > DUTY_PER2Q16(PWM_DUTY_MAX_PER))
+    {
+        output = DUTY_PER2Q16(PWM_DUTY_MAX_PER);
+    }
 
     if (rotor->type == MAIN)
     {
-        PWMGenPeriodSet(PWM_MAIN_BASE, PWM_MAIN_GEN, ui32Period);
         PWMPulseWidthSet(PWM_MAIN_BASE, PWM_MAIN_OUTNUM,
-            ui32Period * rotor->duty / 100);
+            (rotor->period * output) >> 16);
     } else if (rotor->type == TAIL)
     {
-        PWMGenPeriodSet(PWM_TAIL_BASE, PWM_TAIL_GEN, ui32Period);
         PWMPulseWidthSet(PWM_TAIL_BASE, PWM_TAIL_OUTNUM,
-            ui32Period * rotor->duty / 100);
+            (rotor->period * output) >> 16);
     }
 }
 
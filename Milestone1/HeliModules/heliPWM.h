@@ -34,6 +34,11 @@
 #define PWM_DIVIDER_CODE   SYSCTL_PWMDIV_4
 #define PWM_DIVIDER        4
 
+// Duty cycles are Q16 fractions of the period, so 100% is DUTY_Q16_ONE.
+#define DUTY_Q16_ONE       65536
+#define DUTY_PER2Q16(P)    ((int32_t) (P) * DUTY_Q16_ONE / 100)                   // Percent to Q16
+#define DUTY_Q162PER(D)    (((D) * 100 + DUTY_Q16_ONE / 2) / DUTY_Q16_ONE)       // Q16 to percent, rounded
+
 //  PWM Hardware Details
 //  ---Main Rotor PWM: PC5, J4-05 (M0PWM7), gen 3
 #define PWM_MAIN_BASE        PWM0_BASE
@@ -63,8 +68,17 @@ enum motor {MAIN = 0, TAIL};
 typedef struct {
     bool        state;
     uint32_t    freq;
-    uint32_t    duty;
+    uint32_t    duty;    // Q16 fraction of period
+    uint32_t    period;  // PWM load value in ticks, set by setPWM
     enum motor  type;  // MAIN or TAIL
+    // Motor output stage, see motorOutput.h
+    bool        enable;   // Commanded power, output stays on while ramping down
+    bool        limited;  // True when slew limit held duty back from target
+    uint32_t    target;   // Q16 duty the output ramps towards
+    uint32_t    slew;     // Max Q16 duty change per update
+    uint32_t    supplyComp;   // Q16 gain on the duty written to the PWM for supply voltage
+    uint8_t     fault;        // enum rotorFault, see motorOutput.h
+    uint16_t    faultCount;   // Updates the current has been out of range
 } rotor_t;
 
 /*********************************************************
@@ -87,6 +101,15 @@ initPWMTail (rotor_t *rotor);
 void
 setPWM (rotor_t *rotor);
 
+/********************************************************
+ * Function to set only the duty cycle of a rotor, using the
+ * period calculated by setPWM. Only writes the compare register.
+ * Duty is a Q16 fraction of the period. The pulse written is
+ * scaled by supplyComp and limited to PWM_DUTY_MAX_PER.
+ ********************************************************/
+void
+setDuty (rotor_t *rotor, uint32_t duty);
+
 /********************************************************
  * Function to set the power for a rotor.
  ********************************************************/
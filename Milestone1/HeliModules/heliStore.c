@@ -0,0 +1,218 @@
+// *******************************************************
+//
+// heliStore.c
+//
+// Persistent settings in the on-chip EEPROM. Settings are
+// kept as a versioned record with a CRC, written alternately
+// to two slots with a sequence number so a reset part way
+// through a write always leaves the previous copy intact.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+#include "heliStore.h"
+#include "motorControl.h"
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    uint16_t magic;
+    uint16_t version;       // STORE_VERSION when written
+    uint16_t size;          // Bytes of settings in the record
+    uint16_t reserved;
+    uint32_t seq;           // Incremented each write, newest record is highest
+    uint32_t crc;           // CRC-32 of the rest of the header and the settings
+} storeHeader_t;
+
+typedef union {
+    struct {
+        storeHeader_t header;
+        uint8_t data[STORE_SLOT_WORDS * 4 - sizeof(storeHeader_t)];
+    } rec;
+    uint32_t words[STORE_SLOT_WORDS];
+} storeSlot_t;
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static bool storeReady = false;
+static uint32_t storeSeq;       // Sequence number of the newest record
+static int8_t storeNewest = -1; // Slot holding the newest record, -1 if none
+
+//*****************************************************************************
+// crc32 - Standard CRC-32 (reflected, polynomial 0xEDB88320) over len bytes,
+// continuing from crc.
+//*****************************************************************************
+static uint32_t
+crc32 (uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    uint8_t bit;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+//*****************************************************************************
+// slotCrc - CRC of a slot's header, excluding the CRC, and its settings.
+//*****************************************************************************
+static uint32_t
+slotCrc (const storeSlot_t *slot)
+{
+    uint32_t crc = crc32 (0, (const uint8_t *) &slot->rec.header,
+                          offsetof(storeHeader_t, crc));
+    return crc32 (crc, slot->rec.data, slot->rec.header.size);
+}
+
+//*****************************************************************************
+// readSlot - Reads a slot from EEPROM. Returns true if it holds a valid record.
+//*****************************************************************************
+static bool
+readSlot (uint8_t slot, storeSlot_t *data)
+{
+    EEPROMRead (data->words, slot * STORE_SLOT_WORDS * 4, sizeof(data->words));
+
+    return (data->rec.header.magic == STORE_MAGIC &&
+            data->rec.header.version <= STORE_VERSION &&
+            data->rec.header.size <= sizeof(data->rec.data) &&
+            data->rec.header.crc == slotCrc (data));
+}
+
+//*****************************************************************************
+// migrateSettings - Converts the settings of a record from an older version.
+// Each version only adds fields at the end, so a record fills the fields it
+// has and the rest keep their defaults.
+//*****************************************************************************
+static void
+migrateSettings (const storeSlot_t *slot, settings_t *settings)
+{
+    uint32_t size = slot->rec.header.size;
+
+    defaultSettings (settings);
+    if (size > sizeof(settings_t))
+    {
+        size = sizeof(settings_t);
+    }
+    memcpy (settings, slot->rec.data, size);
+}
+
+//*****************************************************************************
+// initStore - Initialises the EEPROM. Returns false if it cannot be used.
+//*****************************************************************************
+bool
+initStore (void)
+{
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_EEPROM0);
+    while (!SysCtlPeripheralReady (SYSCTL_PERIPH_EEPROM0));
+
+    storeReady = (EEPROMInit () == EEPROM_INIT_OK);
+    storeNewest = -1;
+    storeSeq = 0;
+    return storeReady;
+}
+
+//*****************************************************************************
+// defaultSettings - Fills settings with the compiled in defaults.
+//*****************************************************************************
+void
+defaultSettings (settings_t *settings)
+{
+    const pidGains_t noTune = {1, 1, 1};
+
+    settings->altZero = 0;
+    settings->altRange = 0;
+    settings->hoverDuty = 0;
+    settings->altTune = noTune;
+    settings->yawTune = noTune;
+    settings->ffGain = TAIL_FF_GAIN;
+    settings->ffOffset = TAIL_FF_OFFSET;
+    settings->ffRate = TAIL_FF_RATE_GAIN;
+}
+
+//*****************************************************************************
+// loadSettings - Loads the newest valid record into settings.
+//*****************************************************************************
+bool
+loadSettings (settings_t *settings)
+{
+    storeSlot_t slot;
+    uint8_t i;
+
+    defaultSettings (settings);
+    storeNewest = -1;
+    if (!storeReady)
+    {
+        return false;
+    }
+
+    // Keep the valid record with the highest sequence number.
+    for (i = 0; i < STORE_NUM_SLOTS; i++)
+    {
+        if (readSlot (i, &slot) &&
+                (storeNewest < 0 || (int32_t) (slot.rec.header.seq - storeSeq) > 0))
+        {
+            storeNewest = i;
+            storeSeq = slot.rec.header.seq;
+            migrateSettings (&slot, settings);
+        }
+    }
+    return storeNewest >= 0;
+}
+
+//*****************************************************************************
+// saveSettings - Writes settings to the slot not holding the newest record,
+// then reads it back to check it. Returns true if the write succeeded.
+//*****************************************************************************
+bool
+saveSettings (const settings_t *settings)
+{
+    storeSlot_t slot;
+    storeSlot_t check;
+    uint8_t target = (storeNewest == 0) ? 1 : 0;
+
+    if (!storeReady)
+    {
+        return false;
+    }
+
+    memset (&slot, 0xFF, sizeof(slot));
+    slot.rec.header.magic = STORE_MAGIC;
+    slot.rec.header.version = STORE_VERSION;
+    slot.rec.header.size = sizeof(settings_t);
+    slot.rec.header.reserved = 0;
+    slot.rec.header.seq = storeSeq + 1;
+    memcpy (slot.rec.data, settings, sizeof(settings_t));
+    slot.rec.header.crc = slotCrc (&slot);
+
+    // Only the words holding the record need writing.
+    uint32_t bytes = (sizeof(storeHeader_t) + sizeof(settings_t) + 3) & ~3u;
+    if (EEPROMProgram (slot.words, target * STORE_SLOT_WORDS * 4, bytes) != 0 ||
+            !readSlot (target, &check) || check.rec.header.seq != slot.rec.header.seq)
+    {
+        return false;
+    }
+
+    // The new record is only newest once it has been checked.
+    storeNewest = target;
+    storeSeq = slot.rec.header.seq;
+    return true;
+}
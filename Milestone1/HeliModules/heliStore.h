@@ -0,0 +1,76 @@
+#ifndef HELISTORE_H_
+#define HELISTORE_H_
+
+// *******************************************************
+//
+// heliStore.h
+//
+// Persistent settings in the on-chip EEPROM. Settings are
+// kept as a versioned record with a CRC, written alternately
+// to two slots with a sequence number so a reset part way
+// through a write always leaves the previous copy intact.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motorControl.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define STORE_MAGIC         0x4845      // Marks a slot holding a record
+#define STORE_VERSION       1           // Layout of settings_t, bump on change
+#define STORE_SLOT_WORDS    32          // EEPROM words kept for each slot
+#define STORE_NUM_SLOTS     2
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+// Settings kept across resets. Only add fields to the end, and bump
+// STORE_VERSION, so older records still load into the fields they had.
+typedef struct {
+    uint16_t altZero;       // ADC reading at landed altitude
+    uint16_t altRange;      // ADC change from landed to full altitude
+    uint32_t hoverDuty;     // Main duty to hover (Q16), 0 if not known
+    pidGains_t altTune;     // Tuned scale of the altitude gain table
+    pidGains_t yawTune;     // Tuned scale of the yaw gain table
+    float ffGain;           // Tail feedforward coefficients
+    float ffOffset;
+    float ffRate;
+} settings_t;
+
+//*****************************************************************************
+// initStore - Initialises the EEPROM. Returns false if it cannot be used.
+//*****************************************************************************
+bool
+initStore (void);
+
+//*****************************************************************************
+// defaultSettings - Fills settings with the compiled in defaults.
+//*****************************************************************************
+void
+defaultSettings (settings_t *settings);
+
+//*****************************************************************************
+// loadSettings - Loads the newest valid record into settings. Fields a record
+// from an older version does not have are set to defaults. Returns false, with
+// settings set to defaults, if no valid record is found.
+//*****************************************************************************
+bool
+loadSettings (settings_t *settings);
+
+//*****************************************************************************
+// saveSettings - Writes settings to the slot not holding the newest record,
+// then reads it back to check it. Returns true if the write succeeded.
+//*****************************************************************************
+bool
+saveSettings (const settings_t *settings);
+
+#endif /* HELISTORE_H_ */
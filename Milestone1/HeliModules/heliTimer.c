@@ -1,4 +1,4 @@
-a// *******************************************************
+// *******************************************************
 //
 // heliTimer.c
 //
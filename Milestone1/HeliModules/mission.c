@@ -0,0 +1,274 @@
+// *******************************************************
+//
+// mission.c
+//
+// Scripted missions. Steps the heli through a table of
+// altitude, yaw and hold time waypoints and measures how
+// well each one is tracked, giving the settle time and the
+// time spent in tolerance. The table starts as the default
+// held in flash and can be replaced over the UART. Works
+// only on the inputs it is given so it does not depend on
+// the hardware.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "mission.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define MS2UPDATES(T)       ((uint32_t) (T) * MISSION_UPDATE_RATE / 1000)
+#define UPDATES2MS(N)       ((uint32_t) (N) * 1000 / MISSION_UPDATE_RATE)
+#define HALF_CIRC_DEG       180
+
+// Altitude and yaw steps, each held long enough to settle.
+static const waypoint_t defaultMission[] = {
+    {50,    0,  8000},
+    {30,    0,  8000},
+    {30,   90,  8000},
+    {60,  -90,  8000},
+    {60,    0,  8000},
+    {10,    0,  8000},
+};
+
+#define NUM_DEFAULT_WAYPOINTS   (sizeof(defaultMission) / sizeof(defaultMission[0]))
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static waypoint_t mission[MISSION_MAX_WAYPOINTS];
+static uint8_t numWaypoints;
+static bool armed;
+static bool running;
+
+// Waypoint in progress
+static uint8_t wpIndex;
+static uint32_t wpUpdates;          // Updates since the waypoint was set
+static uint32_t settleUpdates;      // Updates when it last came into tolerance
+static uint32_t inTolUpdates;       // Updates spent in tolerance
+static bool wasInTol;
+
+// Results, a ring of the last MISSION_MAX_WAYPOINTS waypoints
+static wpResult_t results[MISSION_MAX_WAYPOINTS];
+static uint32_t resultWrite;
+static uint32_t resultRead;
+
+//*****************************************************************************
+// startWaypoint - Sets index as the waypoint in progress.
+//*****************************************************************************
+static void
+startWaypoint (uint8_t index)
+{
+    wpIndex = index;
+    wpUpdates = 0;
+    inTolUpdates = 0;
+    wasInTol = false;
+}
+
+//*****************************************************************************
+// logResult - Adds the result of the waypoint in progress, dropping the oldest
+// if the log is full.
+//*****************************************************************************
+static void
+logResult (void)
+{
+    wpResult_t *result = &results[resultWrite % MISSION_MAX_WAYPOINTS];
+
+    result->index = wpIndex;
+    result->settleMs = wasInTol ? (int32_t) UPDATES2MS(settleUpdates) : MISSION_NOT_SETTLED;
+    result->inTolMs = UPDATES2MS(inTolUpdates);
+    resultWrite++;
+    if (resultWrite - resultRead > MISSION_MAX_WAYPOINTS)
+    {
+        resultRead = resultWrite - MISSION_MAX_WAYPOINTS;
+    }
+}
+
+//*****************************************************************************
+// initMission - Loads the default mission and clears the results.
+//*****************************************************************************
+void
+initMission (void)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_DEFAULT_WAYPOINTS; i++)
+    {
+        mission[i] = defaultMission[i];
+    }
+    numWaypoints = NUM_DEFAULT_WAYPOINTS;
+    armed = false;
+    running = false;
+    resultRead = resultWrite = 0;
+}
+
+//*****************************************************************************
+// clearMission - Removes all waypoints. Returns false if a mission is running.
+//*****************************************************************************
+bool
+clearMission (void)
+{
+    if (running)
+    {
+        return false;
+    }
+    numWaypoints = 0;
+    armed = false;
+    return true;
+}
+
+//*****************************************************************************
+// addWaypoint - Adds a waypoint to the end of the mission. Returns false if
+// the mission is full or running.
+//*****************************************************************************
+bool
+addWaypoint (const waypoint_t *wp)
+{
+    if (running || numWaypoints >= MISSION_MAX_WAYPOINTS)
+    {
+        return false;
+    }
+    mission[numWaypoints++] = *wp;
+    return true;
+}
+
+//*****************************************************************************
+// getNumWaypoints - Returns the number of waypoints in the mission.
+//*****************************************************************************
+uint8_t
+getNumWaypoints (void)
+{
+    return numWaypoints;
+}
+
+//*****************************************************************************
+// armMission - Arms or disarms the mission to run on the next flight. Only
+// a mission with waypoints can be armed.
+//*****************************************************************************
+void
+armMission (bool arm)
+{
+    armed = arm && numWaypoints > 0;
+}
+
+//*****************************************************************************
+// missionArmed - Returns true if the mission is armed.
+//*****************************************************************************
+bool
+missionArmed (void)
+{
+    return armed;
+}
+
+//*****************************************************************************
+// startMission - Starts the mission from the first waypoint and disarms it.
+//*****************************************************************************
+void
+startMission (void)
+{
+    armed = false;
+    running = numWaypoints > 0;
+    startWaypoint (0);
+}
+
+//*****************************************************************************
+// stopMission - Stops the mission. The waypoint in progress is not logged.
+//*****************************************************************************
+void
+stopMission (void)
+{
+    running = false;
+}
+
+//*****************************************************************************
+// missionRunning - Returns true while a mission is running.
+//*****************************************************************************
+bool
+missionRunning (void)
+{
+    return running;
+}
+
+//*****************************************************************************
+// updateMission - Checks the measured altitude in % and yaw in degrees
+// against the current waypoint, moving to the next once its hold time is up.
+// Call at MISSION_UPDATE_RATE. Returns true, with target set to the waypoint
+// to fly to, while the mission is running.
+//*****************************************************************************
+bool
+updateMission (float alt, float yawDeg, waypoint_t *target)
+{
+    const waypoint_t *wp = &mission[wpIndex];
+
+    if (!running)
+    {
+        return false;
+    }
+
+    // Yaw error the short way round.
+    float yawError = yawDeg - wp->yaw;
+    while (yawError > HALF_CIRC_DEG)
+    {
+        yawError -= 2 * HALF_CIRC_DEG;
+    }
+    while (yawError < -HALF_CIRC_DEG)
+    {
+        yawError += 2 * HALF_CIRC_DEG;
+    }
+
+    // Settled from the last time it came into tolerance, if it stays there.
+    bool inTol = fabsf (alt - wp->alt) <= MISSION_ALT_TOL_PER &&
+                 fabsf (yawError) <= MISSION_YAW_TOL_DEG;
+    if (inTol)
+    {
+        if (!wasInTol)
+        {
+            settleUpdates = wpUpdates;
+        }
+        inTolUpdates++;
+    }
+    wasInTol = inTol;
+    wpUpdates++;
+
+    // The hold time runs from the waypoint being set so every run takes
+    // the same time whatever the controller does.
+    if (wpUpdates >= MS2UPDATES(wp->holdMs))
+    {
+        logResult ();
+        if (wpIndex + 1 < numWaypoints)
+        {
+            startWaypoint (wpIndex + 1);
+        } else {
+            running = false;
+            return false;
+        }
+    }
+
+    *target = mission[wpIndex];
+    return true;
+}
+
+//*****************************************************************************
+// takeMissionResult - Gets the oldest waypoint result not yet taken. Returns
+// false if there are none.
+//*****************************************************************************
+bool
+takeMissionResult (wpResult_t *result)
+{
+    if (resultRead == resultWrite)
+    {
+        return false;
+    }
+    *result = results[resultRead % MISSION_MAX_WAYPOINTS];
+    resultRead++;
+    return true;
+}
@@ -0,0 +1,124 @@
+#ifndef MISSION_H_
+#define MISSION_H_
+
+// *******************************************************
+//
+// mission.h
+//
+// Scripted missions. Steps the heli through a table of
+// altitude, yaw and hold time waypoints and measures how
+// well each one is tracked, giving the settle time and the
+// time spent in tolerance. The table starts as the default
+// held in flash and can be replaced over the UART. Works
+// only on the inputs it is given so it does not depend on
+// the hardware.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define MISSION_UPDATE_RATE     100     // Rate updateMission is called at in Hz
+#define MISSION_MAX_WAYPOINTS   16      // Most waypoints in a mission
+#define MISSION_ALT_TOL_PER     2       // Altitude error counted as in tolerance in %
+#define MISSION_YAW_TOL_DEG     3       // Yaw error counted as in tolerance in degrees
+#define MISSION_MAX_HOLD_MS     UINT16_MAX
+#define MISSION_NOT_SETTLED     (-1)    // Settle time of a waypoint never held in tolerance
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    int16_t alt;            // Altitude in %
+    int16_t yaw;            // Yaw in degrees, -180 to 180
+    uint16_t holdMs;        // Time from the waypoint being set until the next one
+} waypoint_t;
+
+typedef struct {
+    uint8_t index;          // Waypoint the result is for
+    int32_t settleMs;       // Time until it stayed in tolerance, or MISSION_NOT_SETTLED
+    uint32_t inTolMs;       // Time spent in tolerance
+} wpResult_t;
+
+//*****************************************************************************
+// initMission - Loads the default mission and clears the results.
+//*****************************************************************************
+void
+initMission (void);
+
+//*****************************************************************************
+// clearMission - Removes all waypoints. Returns false if a mission is running.
+//*****************************************************************************
+bool
+clearMission (void);
+
+//*****************************************************************************
+// addWaypoint - Adds a waypoint to the end of the mission. Returns false if
+// the mission is full or running.
+//*****************************************************************************
+bool
+addWaypoint (const waypoint_t *wp);
+
+//*****************************************************************************
+// getNumWaypoints - Returns the number of waypoints in the mission.
+//*****************************************************************************
+uint8_t
+getNumWaypoints (void);
+
+//*****************************************************************************
+// armMission - Arms or disarms the mission to run on the next flight. Only
+// a mission with waypoints can be armed.
+//*****************************************************************************
+void
+armMission (bool arm);
+
+//*****************************************************************************
+// missionArmed - Returns true if the mission is armed.
+//*****************************************************************************
+bool
+missionArmed (void);
+
+//*****************************************************************************
+// startMission - Starts the mission from the first waypoint and disarms it.
+//*****************************************************************************
+void
+startMission (void);
+
+//*****************************************************************************
+// stopMission - Stops the mission. The waypoint in progress is not logged.
+//*****************************************************************************
+void
+stopMission (void);
+
+//*****************************************************************************
+// missionRunning - Returns true while a mission is running.
+//*****************************************************************************
+bool
+missionRunning (void);
+
+//*****************************************************************************
+// updateMission - Checks the measured altitude in % and yaw in degrees
+// against the current waypoint, moving to the next once its hold time is up.
+// Call at MISSION_UPDATE_RATE. Returns true, with target set to the waypoint
+// to fly to, while the mission is running.
+//*****************************************************************************
+bool
+updateMission (float alt, float yawDeg, waypoint_t *target);
+
+//*****************************************************************************
+// takeMissionResult - Gets the oldest waypoint result not yet taken. Returns
+// false if there are none.
+//*****************************************************************************
+bool
+takeMissionResult (wpResult_t *result);
+
+#endif /* MISSION_H_ */
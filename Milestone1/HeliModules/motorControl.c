@@ -16,7 +16,55 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "motorControl.h"
+#include "motorOutput.h"
 #include "yaw.h"
+#include "altEstimator.h"
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    int16_t alt;            // Altitude in % these gains apply at
+    pidGains_t altGains;
+    pidGains_t yawGains;
+} gainPoint_t;
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define GAIN_POINTS     4   // Altitudes in each gain table
+
+// Gains at each altitude, in increasing altitude, for each gain set. Gains are
+// interpolated between altitudes. Near the ground the extra lift from ground
+// effect needs more damping, and near the top the main rotor is close to its
+// limit so the gains are reduced to stop oscillation.
+static const gainPoint_t gainTable[NUM_GAIN_SETS][GAIN_POINTS] = {
+    [GAINS_FLYING] = {
+        {0,   {0.25, 0.1,  0.3}, {0.5, 0.09, 0.1}},
+        {20,  {0.2,  0.1,  0.2}, {0.5, 0.09, 0.1}},
+        {70,  {0.2,  0.1,  0.2}, {0.5, 0.09, 0.1}},
+        {100, {0.15, 0.08, 0.2}, {0.45, 0.08, 0.12}}
+    },
+    [GAINS_LANDING] = {
+        {0,   {0.2,  0.05, 0.3}, {0.5, 0.09, 0.1}},
+        {20,  {0.15, 0.05, 0.2}, {0.5, 0.09, 0.1}},
+        {70,  {0.15, 0.05, 0.2}, {0.5, 0.09, 0.1}},
+        {100, {0.15, 0.05, 0.2}, {0.45, 0.08, 0.12}}
+    }
+};
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static pidGains_t altGains = {0.2, 0.1, 0.2};
+static pidGains_t yawGains = {0.5, 0.09, 0.1};
+static pidGains_t altTune = {1, 1, 1};      // Tuned scale applied to the alt gain table
+static pidGains_t yawTune = {1, 1, 1};      // Tuned scale applied to the yaw gain table
+static pidGains_t altBase = {0.2, 0.1, 0.2};    // Scheduled alt gains before tuning
+static pidGains_t yawBase = {0.5, 0.09, 0.1};   // Scheduled yaw gains before tuning
+static float tailFFGain = TAIL_FF_GAIN;
+static float tailFFOffset = TAIL_FF_OFFSET;
+static float tailFFRateGain = TAIL_FF_RATE_GAIN;
 
 //*****************************************************************************
 // altController - Function to update main motor duty cycle to reduce alt error
@@ -28,16 +76,16 @@ altController(rotor_t *mainRotor, int32_t error)
     // Scales the values up by a constant so integers can be used. This removes rounding errors.
     int32_t errorIntMax = 1000 * DUTYSCALER;
     int32_t errorIntMin = 0;
-    float Kp = 0.2;
-    float Ki = 0.1;
-    float Kd = 0.2;
+    float Kp = altGains.Kp;
+    float Ki = altGains.Ki;
+    float Kd = altGains.Kd;
 
     // Proportional: The error times the proportional gain (Kp)
     int32_t P = error * Kp;
 
-    // Add the current Error to the error integral if current speed is less than maximum.
-    // This removes integral windup.
-    if (mainRotor->duty < PWM_MAX_MAIN)
+    // Add the current Error to the error integral if current speed is less than maximum
+    // and the output is not being held back by its slew limit. This removes integral windup.
+    if (mainRotor->duty < DUTY_PER2Q16(PWM_MAX_MAIN) && !mainRotor->limited)
     {
         altErrorInt += (2 * error + DUTYSCALER) / 2 / DUTYSCALER;
     }
@@ -55,52 +103,54 @@ altController(rotor_t *mainRotor, int32_t error)
     // Integral: Multiply the error sum by the integral gain (Ki)
     int32_t I = Ki * altErrorInt;
 
-    // Derivative: Calculate change in error between now and previous operation,
-    // then multiply by the differential gain (Kd)
-    double D = Kd * (altErrorPrev - error);
+    // Derivative: Use the estimated climb rate as the change in altitude over
+    // one controller period, then multiply by the differential gain (Kd) to
+    // oppose it. This avoids differencing the noisy altitude error.
+    double D = -Kd * getAltVelocity() * DUTYSCALER / CONTROLLER_RATE;
 
-    // Store error to be used to calculate the derivative change next time
-    altErrorPrev = error;
-
-    // Combine the proportional, integral and derivative components and then scales
-    // back down using integer division. This reduces rounding error.
-    int32_t PWM_Duty = (2 * (P + I + D) + DUTYSCALER) / 2 / DUTYSCALER;
+    // Combine the proportional, integral and derivative components, then scale
+    // from percent times DUTYSCALER to a Q16 duty so no resolution is lost.
+    int32_t PWM_Duty = (P + I + D) * DUTY_Q16_ONE / 100 / DUTYSCALER;
 
     // Limit the duty cycle to between maximum and minimum values.
-    if (PWM_Duty > PWM_MAX_MAIN)
+    if (PWM_Duty > DUTY_PER2Q16(PWM_MAX_MAIN))
     {
-        PWM_Duty = PWM_MAX_MAIN;
+        PWM_Duty = DUTY_PER2Q16(PWM_MAX_MAIN);
     }
-    else if (PWM_Duty < PWM_MIN_MAIN)
+    else if (PWM_Duty < DUTY_PER2Q16(PWM_MIN_MAIN))
     {
-        PWM_Duty = PWM_MIN_MAIN;
+        PWM_Duty = DUTY_PER2Q16(PWM_MIN_MAIN);
     }
 
-    // Set the motor to calculated new duty cycle.
-    mainRotor->duty = PWM_Duty;
-    setPWM(mainRotor);
+    // Set the motor to ramp to calculated new duty cycle.
+    setRotorTarget(mainRotor, PWM_Duty);
 }
 
 //*****************************************************************************
 // yawController - Function to update tail motor duty cycle to reduce yaw error
-// value to zero using PID control
+// value to zero using PID control, plus feedforward of the main rotor torque
 //*****************************************************************************
 void
-yawController(rotor_t *tailRotor, int32_t error)
+yawController(rotor_t *tailRotor, const rotor_t *mainRotor, int32_t error)
 {
+    static uint32_t mainDutyPrev;
+
     // Scales the values up by a constant so integers can be used. This removes rounding errors.
+    // The integral may go negative to trim out any excess feedforward.
     int32_t errorIntMax = 10000 * DUTYSCALER;
-    int32_t errorIntMin = 0;
-    float Kp = 0.5;
-    float Ki = 0.09;
-    float Kd = 0.1;
+    int32_t errorIntMin = -errorIntMax;
+    float Kp = yawGains.Kp;
+    float Ki = yawGains.Ki;
+    float Kd = yawGains.Kd;
 
     // Proportional: The error times the proportional gain (Kp)
     int32_t P = error * Kp;
 
     // Add the current Error to the error integral if current speed is less than maximum
-    // and more than minimum. This removes integral windup.
-    if (tailRotor->duty < PWM_MAX && tailRotor->duty > PWM_MIN)
+    // and more than minimum, and the output is not being held back by its slew limit.
+    // This removes integral windup.
+    if (tailRotor->duty < DUTY_PER2Q16(PWM_MAX) && tailRotor->duty > DUTY_PER2Q16(PWM_MIN) &&
+            !tailRotor->limited)
     {
         yawErrorInt += (2 * error + DUTYSCALER) / 2 / DUTYSCALER;
     }
@@ -118,31 +168,190 @@ yawController(rotor_t *tailRotor, int32_t error)
     // Integral: Multiply the error sum by the integral gain (Ki)
     int32_t I = Ki * yawErrorInt;
 
-    // Derivative: Calculate change in error between now and previous operation,
-    // then multiply by the differential gain (Kd)
-    double D = Kd * (yawErrorPrev - error);
-    yawErrorPrev = error;
+    // Derivative: Use the measured yaw rate as the change in yaw over one
+    // controller period, then multiply by the differential gain (Kd) to
+    // oppose it. More tail duty turns the heli towards +yaw.
+    double D = -Kd * getYawRate() * DUTYSCALER / CONTROLLER_RATE;
+
+    // Feedforward: Tail duty to cancel the main rotor reaction torque before it
+    // turns the heli, from the main duty and how fast it is changing.
+    int32_t mainDutyRate = ((int32_t) mainRotor->duty - (int32_t) mainDutyPrev) * CONTROLLER_RATE;
+    mainDutyPrev = mainRotor->duty;
+    int32_t FF = tailFFGain * mainRotor->duty + tailFFOffset * DUTY_Q16_ONE +
+                 tailFFRateGain * mainDutyRate;
 
-    // Combine the proportional, integral and derivative components and then scales
-    // back down using integer division. This reduces rounding error.
-    int32_t PWM_Duty = (2 * (P + I + D) + DUTYSCALER) / 2 / DUTYSCALER;
+    // Combine the proportional, integral and derivative components, then scale
+    // from percent times DUTYSCALER to a Q16 duty so no resolution is lost.
+    int32_t PWM_Duty = (P + I + D) * DUTY_Q16_ONE / 100 / DUTYSCALER + FF;
 
     // Limit the duty cycle to between maximum and minimum values.
-    if (PWM_Duty > PWM_MAX)
+    if (PWM_Duty > DUTY_PER2Q16(PWM_MAX))
     {
-        PWM_Duty = PWM_MAX;
+        PWM_Duty = DUTY_PER2Q16(PWM_MAX);
     }
-    else if (PWM_Duty < PWM_MIN)
+    else if (PWM_Duty < DUTY_PER2Q16(PWM_MIN))
     {
-        PWM_Duty = PWM_MIN;
+        PWM_Duty = DUTY_PER2Q16(PWM_MIN);
     }
 
-    // Set the motor to calculated new duty cycle.
-    tailRotor->duty = PWM_Duty;
-    setPWM(tailRotor);
+    // Set the motor to ramp to calculated new duty cycle.
+    setRotorTarget(tailRotor, PWM_Duty);
 }
 
 
+//*****************************************************************************
+// interpGains - Linearly interpolates between two sets of gains, frac of the
+// way from a to b.
+//*****************************************************************************
+static pidGains_t
+interpGains(const pidGains_t *a, const pidGains_t *b, float frac)
+{
+    pidGains_t gains = {
+        .Kp = a->Kp + (b->Kp - a->Kp) * frac,
+        .Ki = a->Ki + (b->Ki - a->Ki) * frac,
+        .Kd = a->Kd + (b->Kd - a->Kd) * frac
+    };
+    return gains;
+}
+
+//*****************************************************************************
+// scaleGains - Multiplies each gain by the matching gain in scale.
+//*****************************************************************************
+static pidGains_t
+scaleGains(const pidGains_t *gains, const pidGains_t *scale)
+{
+    pidGains_t scaled = {
+        .Kp = gains->Kp * scale->Kp,
+        .Ki = gains->Ki * scale->Ki,
+        .Kd = gains->Kd * scale->Kd
+    };
+    return scaled;
+}
+
+//*****************************************************************************
+// rescaleInt - Rescales an error integral from integral gain KiOld to KiNew,
+// rounding to nearest so repeated rescaling does not drift.
+//*****************************************************************************
+static int32_t
+rescaleInt(int32_t errorInt, float KiOld, float KiNew)
+{
+    if (KiOld == KiNew || KiNew <= 0)
+    {
+        return errorInt;
+    }
+    float scaled = errorInt * KiOld / KiNew;
+    return (int32_t) (scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+//*****************************************************************************
+// scheduleGains - Sets the altitude and yaw controller gains for the current
+// altitude (in %) by interpolating the gain table for the state. The integrals
+// are rescaled so the integral terms do not jump when the gains change.
+//*****************************************************************************
+void
+scheduleGains(int32_t alt, enum gainSet gainSet)
+{
+    const gainPoint_t *table = gainTable[gainSet];
+    uint8_t i = 0;
+    float frac;
+
+    // Find the pair of table altitudes either side of alt, holding the end
+    // gains outside the table.
+    while (i < GAIN_POINTS - 2 && alt > table[i + 1].alt)
+    {
+        i++;
+    }
+    frac = (float) (alt - table[i].alt) / (table[i + 1].alt - table[i].alt);
+    if (frac < 0)
+    {
+        frac = 0;
+    }
+    else if (frac > 1)
+    {
+        frac = 1;
+    }
+
+    altBase = interpGains (&table[i].altGains, &table[i + 1].altGains, frac);
+    yawBase = interpGains (&table[i].yawGains, &table[i + 1].yawGains, frac);
+    pidGains_t newAlt = scaleGains (&altBase, &altTune);
+    pidGains_t newYaw = scaleGains (&yawBase, &yawTune);
+
+    // Keep Ki * integral the same across the change so the output does not kick.
+    altErrorInt = rescaleInt (altErrorInt, altGains.Ki, newAlt.Ki);
+    yawErrorInt = rescaleInt (yawErrorInt, yawGains.Ki, newYaw.Ki);
+
+    altGains = newAlt;
+    yawGains = newYaw;
+}
+
+//*****************************************************************************
+// getGains - Gets the current scheduled gains for an axis.
+//*****************************************************************************
+void
+getGains(enum pidAxis axis, pidGains_t *gains)
+{
+    *gains = (axis == AXIS_ALT) ? altGains : yawGains;
+}
+
+//*****************************************************************************
+// tuneGains - Scales the gain tables for an axis so the current scheduled
+// gains become gains. Other altitudes and states keep their ratio to them.
+// The new gains take effect at the next scheduleGains.
+//*****************************************************************************
+void
+tuneGains(enum pidAxis axis, const pidGains_t *gains)
+{
+    const pidGains_t *base = (axis == AXIS_ALT) ? &altBase : &yawBase;
+    pidGains_t *tune = (axis == AXIS_ALT) ? &altTune : &yawTune;
+
+    // Scale against the untuned table gains, which are never zero, so a gain
+    // can be tuned to zero and back.
+    tune->Kp = gains->Kp / base->Kp;
+    tune->Ki = gains->Ki / base->Ki;
+    tune->Kd = gains->Kd / base->Kd;
+}
+
+//*****************************************************************************
+// getGainTune - Gets the tuned scale applied to the gain table for an axis.
+//*****************************************************************************
+void
+getGainTune(enum pidAxis axis, pidGains_t *tune)
+{
+    *tune = (axis == AXIS_ALT) ? altTune : yawTune;
+}
+
+//*****************************************************************************
+// setGainTune - Sets the tuned scale applied to the gain table for an axis.
+// The new gains take effect at the next scheduleGains.
+//*****************************************************************************
+void
+setGainTune(enum pidAxis axis, const pidGains_t *tune)
+{
+    if (axis == AXIS_ALT)
+    {
+        altTune = *tune;
+    } else {
+        yawTune = *tune;
+    }
+}
+
+//*****************************************************************************
+// presetAltIntegral - Sets the altitude integral so the controller starts out
+// holding hoverDuty (Q16), so the heli does not sag when it starts flying.
+//*****************************************************************************
+void
+presetAltIntegral(uint32_t hoverDuty)
+{
+    // The integral term is Ki * altErrorInt in percent times DUTYSCALER.
+    // With no integral gain there is nothing to hold it.
+    if (altGains.Ki <= 0)
+    {
+        altErrorInt = 0;
+        return;
+    }
+    altErrorInt = (float) hoverDuty * 100 / DUTY_Q16_ONE * DUTYSCALER / altGains.Ki;
+}
+
 //*****************************************************************************
 // fly - Controls heli to desired position and angle
 //*****************************************************************************
@@ -150,7 +359,29 @@ void
 fly (rotor_t *mainRotor, rotor_t *tailRotor, int32_t altError, int32_t yawError)
 {
     altController (mainRotor, altError);
-    yawController (tailRotor, yawError);
+    yawController (tailRotor, mainRotor, yawError);
+}
+
+//*****************************************************************************
+// setTailFeedforward - Sets the main to tail rotor feedforward coefficients.
+//*****************************************************************************
+void
+setTailFeedforward(float gain, float offset, float rateGain)
+{
+    tailFFGain = gain;
+    tailFFOffset = offset;
+    tailFFRateGain = rateGain;
+}
+
+//*****************************************************************************
+// getTailFeedforward - Gets the main to tail rotor feedforward coefficients.
+//*****************************************************************************
+void
+getTailFeedforward(float *gain, float *offset, float *rateGain)
+{
+    *gain = tailFFGain;
+    *offset = tailFFOffset;
+    *rateGain = tailFFRateGain;
 }
 
 //*****************************************************************************
@@ -167,20 +398,19 @@ integrate(int32_t altError, int32_t yawError)
 // Function to calculate altitude error.
 //*****************************************************************************
 int32_t
-calcAltError(int32_t desiredAlt, int32_t actualAlt)
+calcAltError(float desiredAlt, float actualAlt)
 {
     // Scales the values up by a constant so integers can be used. This removes rounding errors.
-    return (desiredAlt * DUTYSCALER) - (actualAlt * DUTYSCALER);
+    return (int32_t) ((desiredAlt - actualAlt) * DUTYSCALER);
 }
 
 //*****************************************************************************
 // Function to calculate yaw error.
 //*****************************************************************************
 int32_t
-calcYawError(int32_t desiredYaw, int32_t actualYaw)
+calcYawError(yawAngle_t desiredYaw, yawAngle_t actualYaw)
 {
-    // Scales the values up by a constant so integers can be used. This removes rounding errors.
-    int32_t error = (desiredYaw * DUTYSCALER) - (YAW_DEG(actualYaw) * DUTYSCALER);
-
-    return error;
+    // Binary angle difference wraps to within +-180 deg, then scale to thousandths
+    // of a degree to match the DUTYSCALER scaling of the controller.
+    return YAW_ANGLE2MDEG((yawAngle_t) (desiredYaw - actualYaw));
 }
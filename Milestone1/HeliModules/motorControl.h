@@ -19,26 +19,43 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "heliPWM.h"
+#include "yaw.h"
 
 //*****************************************************************************
 // Constants
 //*****************************************************************************
+#define CONTROLLER_RATE     100    // Rate controllers are updated at in Hz
+#define CONTROLLER_DT       (1.0f / CONTROLLER_RATE)   // Time between controller updates in s
 #define ROTATE_DUTY_TAIL    28     // Rotate duty cycle for tail
 #define TIME_STEP           1000   // Time step between samples of derivative
-#define DROP_ALT_STEP       4      // Altitude drop step when landing
 #define DUTYSCALER 1000            // Prescaler for error so integers can be used.
 #define PWM_MIN    5
 #define PWM_MAX    70
 #define PWM_MAX_MAIN 60
 #define PWM_MIN_MAIN 25
 
+//---Tail rotor feedforward from main rotor duty, tail = gain * main + offset.
+//   Defaults hold until a tail calibration is run.
+#define TAIL_FF_GAIN        0.0f   // Tail duty per unit of main duty
+#define TAIL_FF_OFFSET      0.0f   // Tail duty at zero main duty, fraction of period
+#define TAIL_FF_RATE_GAIN   0.0f   // Tail duty per unit/s of main duty change
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum gainSet {GAINS_FLYING = 0, GAINS_LANDING, NUM_GAIN_SETS};   // Gain tables by state
+enum pidAxis {AXIS_ALT = 0, AXIS_YAW};
+typedef struct {
+    float Kp;
+    float Ki;
+    float Kd;
+} pidGains_t;
+
 //*****************************************************************************
 // Global variables
 //*****************************************************************************
 static int32_t yawErrorInt;
 static int32_t altErrorInt;
-static int32_t yawErrorPrev;
-static int32_t altErrorPrev;
 
 //*****************************************************************************
 // altController - Function to update main motor duty cycle to reduce alt error
@@ -49,10 +66,65 @@ altController(rotor_t *mainRotor, int32_t error);
 
 //*****************************************************************************
 // yawController - Function to update tail motor duty cycle to reduce yaw error
-// value to zero using PID control
+// value to zero using PID control, plus feedforward of the main rotor torque
+//*****************************************************************************
+void
+yawController(rotor_t *tailRotor, const rotor_t *mainRotor, int32_t error);
+
+//*****************************************************************************
+// setTailFeedforward - Sets the main to tail rotor feedforward coefficients.
+// gain and offset give the tail duty needed to hold yaw at a steady main duty,
+// rateGain adds tail duty while the main duty is changing.
+//*****************************************************************************
+void
+setTailFeedforward(float gain, float offset, float rateGain);
+
+//*****************************************************************************
+// getTailFeedforward - Gets the main to tail rotor feedforward coefficients.
+//*****************************************************************************
+void
+getTailFeedforward(float *gain, float *offset, float *rateGain);
+
+//*****************************************************************************
+// scheduleGains - Sets the altitude and yaw controller gains for the current
+// altitude (in %) by interpolating the gain table for the state. The integrals
+// are rescaled so the integral terms do not jump when the gains change.
+//*****************************************************************************
+void
+scheduleGains(int32_t alt, enum gainSet gainSet);
+
+//*****************************************************************************
+// getGains - Gets the current scheduled gains for an axis.
+//*****************************************************************************
+void
+getGains(enum pidAxis axis, pidGains_t *gains);
+
+//*****************************************************************************
+// tuneGains - Scales the gain tables for an axis so the current scheduled
+// gains become gains. Other altitudes and states keep their ratio to them.
+//*****************************************************************************
+void
+tuneGains(enum pidAxis axis, const pidGains_t *gains);
+
+//*****************************************************************************
+// getGainTune - Gets the tuned scale applied to the gain table for an axis.
+//*****************************************************************************
+void
+getGainTune(enum pidAxis axis, pidGains_t *tune);
+
+//*****************************************************************************
+// setGainTune - Sets the tuned scale applied to the gain table for an axis,
+// such as one saved from an earlier tuning.
+//*****************************************************************************
+void
+setGainTune(enum pidAxis axis, const pidGains_t *tune);
+
+//*****************************************************************************
+// presetAltIntegral - Sets the altitude integral so the controller starts out
+// holding hoverDuty (Q16), so the heli does not sag when it starts flying.
 //*****************************************************************************
 void
-yawController(rotor_t *tailRotor, int32_t error);
+presetAltIntegral(uint32_t hoverDuty);
 
 //*****************************************************************************
 // fly - Controls heli to desired position and angle
@@ -70,12 +142,12 @@ integrate(int32_t altError, int32_t yawError);
 // Function to calculate altitude error.
 //*****************************************************************************
 int32_t
-calcAltError(int32_t desiredAlt, int32_t actualAlt);
+calcAltError(float desiredAlt, float actualAlt);
 
 //*****************************************************************************
 // Function to calculate yaw error.
 //*****************************************************************************
 int32_t
-calcYawError(int32_t desiredYaw, int32_t actualYaw);
+calcYawError(yawAngle_t desiredYaw, yawAngle_t actualYaw);
 
 #endif /* MOTORCONTROL_H_ */
@@ -0,0 +1,216 @@
+// *******************************************************
+//
+// motorOutput.c
+//
+// Motor output stage between the controllers and the PWM
+// module. Limits how fast each rotor duty cycle can change
+// and ramps rotors up on start and down on stop. Scales the
+// output for the supply voltage and checks the rotor current
+// for faults.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motorOutput.h"
+#include "motorControl.h"
+#include "heliPWM.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static bool currentCheck = ROTOR_CURRENT_CHECK;
+
+//*****************************************************************************
+// initMotorOutput - Sets the slew limit for a rotor in %/s. Call after
+// the rotor PWM has been initialised.
+//*****************************************************************************
+void
+initMotorOutput (rotor_t *rotor, uint32_t slewPerSec)
+{
+    setRotorSlew (rotor, slewPerSec);
+    rotor->target = rotor->duty;
+    rotor->enable = rotor->state;
+    rotor->limited = false;
+    rotor->fault = ROTOR_OK;
+    rotor->faultCount = 0;
+}
+
+//*****************************************************************************
+// setRotorSlew - Sets the slew limit for a rotor in %/s.
+//*****************************************************************************
+void
+setRotorSlew (rotor_t *rotor, uint32_t slewPerSec)
+{
+    rotor->slew = DUTY_PER2Q16(slewPerSec) / CONTROLLER_RATE;
+}
+
+//*****************************************************************************
+// setRotorTarget - Sets the duty cycle (Q16) the rotor ramps towards.
+//*****************************************************************************
+void
+setRotorTarget (rotor_t *rotor, uint32_t duty)
+{
+    rotor->target = duty;
+}
+
+//*****************************************************************************
+// setRotorEnable - Soft starts or soft stops a rotor. A started rotor ramps
+// up from RAMP_FLOOR_PER to its target, a stopped rotor ramps down to
+// RAMP_FLOOR_PER and then its output is turned off.
+//*****************************************************************************
+void
+setRotorEnable (rotor_t *rotor, bool enable)
+{
+    // Start ramp from the floor if the output is off.
+    if (enable && !rotor->state)
+    {
+        setDuty (rotor, DUTY_PER2Q16(RAMP_FLOOR_PER));
+        motorPower (rotor, true);
+        rotor->fault = ROTOR_OK;
+        rotor->faultCount = 0;
+    }
+    rotor->enable = enable;
+}
+
+//*****************************************************************************
+// updateMotorOutput - Moves the rotor duty cycle towards its target by at
+// most the slew limit and writes it to the PWM. Call at CONTROLLER_RATE.
+//*****************************************************************************
+void
+updateMotorOutput (rotor_t *rotor)
+{
+    uint32_t floorDuty = DUTY_PER2Q16(RAMP_FLOOR_PER);
+    uint32_t goal = rotor->enable ? rotor->target : floorDuty;
+    uint32_t duty = rotor->duty;
+
+    // Nothing to do for a rotor that is off and staying off.
+    if (!rotor->state)
+    {
+        rotor->limited = false;
+        return;
+    }
+
+    // Step towards goal, flagging when the slew limit stops it getting there
+    // so the controllers can hold their integrators.
+    if (goal > duty + rotor->slew)
+    {
+        duty += rotor->slew;
+        rotor->limited = true;
+    }
+    else if (duty > goal + rotor->slew)
+    {
+        duty -= rotor->slew;
+        rotor->limited = true;
+    }
+    else
+    {
+        duty = goal;
+        rotor->limited = false;
+    }
+
+    if (duty != rotor->duty)
+    {
+        setDuty (rotor, duty);
+    }
+
+    // Turn output off once a soft stop has ramped down.
+    if (!rotor->enable && duty <= floorDuty)
+    {
+        motorPower (rotor, false);
+    }
+}
+
+//*****************************************************************************
+// updateSupplyComp - Scales the rotor output to give the duty it would have at
+// SUPPLY_NOMINAL_MV from a supply of supplyMv.
+//*****************************************************************************
+void
+updateSupplyComp (rotor_t *rotor, uint32_t supplyMv)
+{
+    uint32_t comp = DUTY_Q16_ONE;
+
+    // Motor speed follows the mean voltage, so scale the duty by the drop.
+    if (supplyMv >= SUPPLY_MIN_MV && supplyMv <= SUPPLY_MAX_MV)
+    {
+        comp = (uint64_t) SUPPLY_NOMINAL_MV * DUTY_Q16_ONE / supplyMv;
+        if (comp > DUTY_PER2Q16(SUPPLY_COMP_MAX_PER))
+        {
+            comp = DUTY_PER2Q16(SUPPLY_COMP_MAX_PER);
+        }
+    }
+
+    if (comp != rotor->supplyComp)
+    {
+        rotor->supplyComp = comp;
+        setDuty (rotor, rotor->duty);
+    }
+}
+
+//*****************************************************************************
+// checkRotorCurrent - Sets the rotor fault once currentMa has been too low for
+// the duty, or too high, for ROTOR_FAULT_UPDATES calls. A fault stays set until
+// the rotor is next started, or the checks are turned off. Returns the rotor
+// fault.
+//*****************************************************************************
+enum rotorFault
+checkRotorCurrent (rotor_t *rotor, uint32_t currentMa)
+{
+    enum rotorFault found = ROTOR_OK;
+
+    if (!currentCheck)
+    {
+        rotor->fault = ROTOR_OK;
+        rotor->faultCount = 0;
+        return ROTOR_OK;
+    }
+    if (rotor->fault != ROTOR_OK || !rotor->state)
+    {
+        return rotor->fault;
+    }
+
+    if (currentMa > ROTOR_STALL_MA)
+    {
+        found = ROTOR_STALL;
+    }
+    else if (currentMa < ROTOR_OPEN_MA && rotor->duty >= DUTY_PER2Q16(ROTOR_OPEN_MIN_PER))
+    {
+        found = ROTOR_OPEN;
+    }
+
+    // Only set a fault once it has lasted, so start up current is ignored.
+    if (found == ROTOR_OK)
+    {
+        rotor->faultCount = 0;
+    }
+    else if (++rotor->faultCount >= ROTOR_FAULT_UPDATES)
+    {
+        rotor->fault = found;
+    }
+    return rotor->fault;
+}
+
+//*****************************************************************************
+// setRotorCurrentCheck - Turns the rotor current checks on or off. While off,
+// the rotor faults are cleared at the next check.
+//*****************************************************************************
+void
+setRotorCurrentCheck (bool check)
+{
+    currentCheck = check;
+}
+
+//*****************************************************************************
+// getRotorCurrentCheck - Returns true if the rotor current checks are on.
+//*****************************************************************************
+bool
+getRotorCurrentCheck (void)
+{
+    return currentCheck;
+}
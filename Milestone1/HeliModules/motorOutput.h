@@ -0,0 +1,117 @@
+#ifndef MOTOROUTPUT_H_
+#define MOTOROUTPUT_H_
+
+// *******************************************************
+//
+// motorOutput.h
+//
+// Motor output stage between the controllers and the PWM
+// module. Limits how fast each rotor duty cycle can change
+// and ramps rotors up on start and down on stop. Scales the
+// output for the supply voltage and checks the rotor current
+// for faults.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "heliPWM.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define MAIN_SLEW_PER_S     100     // Max main rotor duty change in %/s
+#define TAIL_SLEW_PER_S     200     // Max tail rotor duty change in %/s
+#define RAMP_FLOOR_PER      PWM_DUTY_MIN_PER    // Duty ramps start from and stop at
+
+//---Supply compensation. Readings outside the valid range are taken as no
+//   supply sensor and the output is not scaled.
+#define SUPPLY_NOMINAL_MV   12000   // Supply voltage the gains were tuned at
+#define SUPPLY_MIN_MV       8000    // Lowest valid supply reading
+#define SUPPLY_MAX_MV       16000   // Highest valid supply reading
+#define SUPPLY_COMP_MAX_PER 125     // Largest output scaling, percent
+
+//---Rotor current faults, checked at CONTROLLER_RATE. Off until the current
+//   sensors are fitted and CURRENT_MA_PER_MV in heliADC.h suits them, as with
+//   no sensor every flight would read as an open circuit.
+#define ROTOR_CURRENT_CHECK false   // Current checks on at reset
+#define ROTOR_OPEN_MA       50      // Less current than this while driven is an open circuit
+#define ROTOR_OPEN_MIN_PER  20      // Least duty the open circuit check applies at
+#define ROTOR_STALL_MA      2500    // More current than this is a stalled rotor
+#define ROTOR_FAULT_UPDATES 50      // Updates out of range before a fault is set
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum rotorFault {ROTOR_OK = 0, ROTOR_OPEN, ROTOR_STALL};
+
+//*****************************************************************************
+// initMotorOutput - Sets the slew limit for a rotor in %/s. Call after
+// the rotor PWM has been initialised.
+//*****************************************************************************
+void
+initMotorOutput (rotor_t *rotor, uint32_t slewPerSec);
+
+//*****************************************************************************
+// setRotorSlew - Sets the slew limit for a rotor in %/s.
+//*****************************************************************************
+void
+setRotorSlew (rotor_t *rotor, uint32_t slewPerSec);
+
+//*****************************************************************************
+// setRotorTarget - Sets the duty cycle (Q16) the rotor ramps towards.
+//*****************************************************************************
+void
+setRotorTarget (rotor_t *rotor, uint32_t duty);
+
+//*****************************************************************************
+// setRotorEnable - Soft starts or soft stops a rotor. A started rotor ramps
+// up from RAMP_FLOOR_PER to its target, a stopped rotor ramps down to
+// RAMP_FLOOR_PER and then its output is turned off.
+//*****************************************************************************
+void
+setRotorEnable (rotor_t *rotor, bool enable);
+
+//*****************************************************************************
+// updateMotorOutput - Moves the rotor duty cycle towards its target by at
+// most the slew limit and writes it to the PWM. Call at CONTROLLER_RATE.
+//*****************************************************************************
+void
+updateMotorOutput (rotor_t *rotor);
+
+//*****************************************************************************
+// updateSupplyComp - Scales the rotor output to give the duty it would have at
+// SUPPLY_NOMINAL_MV from a supply of supplyMv.
+//*****************************************************************************
+void
+updateSupplyComp (rotor_t *rotor, uint32_t supplyMv);
+
+//*****************************************************************************
+// checkRotorCurrent - Sets the rotor fault once currentMa has been too low for
+// the duty, or too high, for ROTOR_FAULT_UPDATES calls. A fault stays set until
+// the rotor is next started, or the checks are turned off. Returns the rotor
+// fault.
+//*****************************************************************************
+enum rotorFault
+checkRotorCurrent (rotor_t *rotor, uint32_t currentMa);
+
+//*****************************************************************************
+// setRotorCurrentCheck - Turns the rotor current checks on or off. While off,
+// the rotor faults are cleared at the next check.
+//*****************************************************************************
+void
+setRotorCurrentCheck (bool check);
+
+//*****************************************************************************
+// getRotorCurrentCheck - Returns true if the rotor current checks are on.
+//*****************************************************************************
+bool
+getRotorCurrentCheck (void);
+
+#endif /* MOTOROUTPUT_H_ */
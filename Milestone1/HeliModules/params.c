@@ -0,0 +1,597 @@
+// *******************************************************
+//
+// params.c
+//
+// Runtime parameter store with a UART command interface.
+// Parameters are named, typed and range checked, and can be
+// read with get and list or changed with set. Values from a
+// set are staged and applied together at the start of the
+// next controller update. Calibration and tuning can be saved
+// to the settings store and are loaded at start up.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "utils/ustdlib.h"
+#include "params.h"
+#include "USBUART.h"
+#include "stateMachine.h"
+#include "motorControl.h"
+#include "motorOutput.h"
+#include "autotune.h"
+#include "heliStore.h"
+#include "altEstimator.h"
+#include "heliADC.h"
+#include "mission.h"
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+enum paramType {PARAM_INT = 0, PARAM_FLOAT};
+
+typedef struct {
+    const char *name;
+    enum paramType type;
+    void *value;            // int32_t or float the parameter is stored in
+    float min;
+    float max;
+    void (*apply)(void);    // Pushes the value to where it is used, or NULL
+} param_t;
+
+typedef union {
+    int32_t i;
+    float f;
+} paramValue_t;
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static heli_t *paramHeli;
+
+// Copies of values owned by other modules. Loaded before they are read and
+// pushed back by the apply functions.
+static pidGains_t altGainsParam;
+static pidGains_t yawGainsParam;
+static float ffGain, ffOffset, ffRate;
+static float altRate, altAccel, yawRate, yawAccel;
+static int32_t mainSlew = MAIN_SLEW_PER_S;
+static int32_t tailSlew = TAIL_SLEW_PER_S;
+static int32_t tuneRule = AUTOTUNE_RULE;
+static int32_t altZero, altRange;
+static float estThrust, estAccNoise;
+static int32_t spikeThreshold;
+static int32_t currentCheck;
+
+// Values staged by set, applied at the next controller update
+static uint8_t pendingIndex[PARAM_MAX_PENDING];
+static paramValue_t pendingValue[PARAM_MAX_PENDING];
+static volatile uint8_t pendingCount = 0;
+
+static int16_t listIndex = -1;  // Next parameter to list, -1 when not listing
+
+//*****************************************************************************
+// Apply functions
+//*****************************************************************************
+static void
+applyAltGains (void)
+{
+    tuneGains (AXIS_ALT, &altGainsParam);
+}
+
+static void
+applyYawGains (void)
+{
+    tuneGains (AXIS_YAW, &yawGainsParam);
+}
+
+static void
+applyFeedforward (void)
+{
+    setTailFeedforward (ffGain, ffOffset, ffRate);
+}
+
+static void
+applyTraj (void)
+{
+    // Landing sets its own altitude rate, so only change it when flying.
+    paramHeli->altRate = altRate;
+    if (paramHeli->heliState != LANDING)
+    {
+        paramHeli->altTraj.maxVel = altRate;
+    }
+    paramHeli->altTraj.maxAcc = altAccel;
+    paramHeli->yawTraj.maxVel = yawRate;
+    paramHeli->yawTraj.maxAcc = yawAccel;
+}
+
+static void
+applySlew (void)
+{
+    setRotorSlew (paramHeli->mainRotor, mainSlew);
+    setRotorSlew (paramHeli->tailRotor, tailSlew);
+}
+
+static void
+applyTuneRule (void)
+{
+    setAutotuneRule (tuneRule);
+}
+
+static void
+applyAltCal (void)
+{
+    paramHeli->altZero = altZero;
+    paramHeli->altRange = altRange;
+    if (!paramHeli->initProg)
+    {
+        updateAltLimits (paramHeli);
+    }
+}
+
+static void
+applyAltEst (void)
+{
+    setAltEstModel (estThrust, estAccNoise);
+}
+
+static void
+applySpike (void)
+{
+    setAltSpikeThreshold (spikeThreshold);
+}
+
+static void
+applyCurrentCheck (void)
+{
+    setRotorCurrentCheck (currentCheck);
+}
+
+//*****************************************************************************
+// Parameter registry
+//*****************************************************************************
+static const param_t params[] = {
+    {"alt.kp",      PARAM_FLOAT, &altGainsParam.Kp, 0.001, 10,   applyAltGains},
+    {"alt.ki",      PARAM_FLOAT, &altGainsParam.Ki, 0,     100,  applyAltGains},
+    {"alt.kd",      PARAM_FLOAT, &altGainsParam.Kd, 0,     100,  applyAltGains},
+    {"yaw.kp",      PARAM_FLOAT, &yawGainsParam.Kp, 0.001, 10,   applyYawGains},
+    {"yaw.ki",      PARAM_FLOAT, &yawGainsParam.Ki, 0,     100,  applyYawGains},
+    {"yaw.kd",      PARAM_FLOAT, &yawGainsParam.Kd, 0,     100,  applyYawGains},
+    {"ff.gain",     PARAM_FLOAT, &ffGain,           -2,    2,    applyFeedforward},
+    {"ff.offset",   PARAM_FLOAT, &ffOffset,         -1,    1,    applyFeedforward},
+    {"ff.rate",     PARAM_FLOAT, &ffRate,           -1,    1,    applyFeedforward},
+    {"alt.rate",    PARAM_FLOAT, &altRate,          1,     100,  applyTraj},
+    {"alt.accel",   PARAM_FLOAT, &altAccel,         1,     500,  applyTraj},
+    {"yaw.rate",    PARAM_FLOAT, &yawRate,          1,     720,  applyTraj},
+    {"yaw.accel",   PARAM_FLOAT, &yawAccel,         1,     2000, applyTraj},
+    {"alt.step",    PARAM_INT,   &altStepPer,       1,     ALT_MAX_PER, NULL},
+    {"yaw.step",    PARAM_INT,   &yawStepDeg,       1,     180,  NULL},
+    {"main.slew",   PARAM_INT,   &mainSlew,         1,     1000, applySlew},
+    {"tail.slew",   PARAM_INT,   &tailSlew,         1,     1000, applySlew},
+    {"tune.rule",   PARAM_INT,   &tuneRule,         TUNE_ZIEGLER_NICHOLS, TUNE_TYREUS_LUYBEN, applyTuneRule},
+    {"alt.zero",    PARAM_INT,   &altZero,          0,     4095, applyAltCal},
+    {"alt.range",   PARAM_INT,   &altRange,         1,     4095, applyAltCal},
+    {"est.thrust",  PARAM_FLOAT, &estThrust,        1,     200,  applyAltEst},
+    {"est.acc",     PARAM_FLOAT, &estAccNoise,      0.1,   1000, applyAltEst},
+    {"alt.spike",   PARAM_INT,   &spikeThreshold,   0,     4095, applySpike},
+    {"cur.check",   PARAM_INT,   &currentCheck,     0,     1,    applyCurrentCheck},
+};
+
+#define NUM_PARAMS  (sizeof(params) / sizeof(params[0]))
+
+//*****************************************************************************
+// refreshParams - Loads the copies of values owned by other modules.
+//*****************************************************************************
+static void
+refreshParams (void)
+{
+    getGains (AXIS_ALT, &altGainsParam);
+    getGains (AXIS_YAW, &yawGainsParam);
+    getTailFeedforward (&ffGain, &ffOffset, &ffRate);
+    altRate = paramHeli->altRate;
+    altAccel = paramHeli->altTraj.maxAcc;
+    yawRate = paramHeli->yawTraj.maxVel;
+    yawAccel = paramHeli->yawTraj.maxAcc;
+    altZero = paramHeli->altZero;
+    altRange = paramHeli->altRange;
+    getAltEstModel (&estThrust, &estAccNoise);
+    spikeThreshold = getAltSpikeThreshold ();
+    currentCheck = getRotorCurrentCheck ();
+}
+
+//*****************************************************************************
+// loadParams - Applies the settings saved in the store, if there are any.
+//*****************************************************************************
+static void
+loadParams (void)
+{
+    settings_t settings;
+
+    if (!loadSettings (&settings))
+    {
+        return;
+    }
+
+    paramHeli->altZero = settings.altZero;
+    paramHeli->altRange = settings.altRange;
+    paramHeli->hoverDuty = settings.hoverDuty;
+    setGainTune (AXIS_ALT, &settings.altTune);
+    setGainTune (AXIS_YAW, &settings.yawTune);
+    setTailFeedforward (settings.ffGain, settings.ffOffset, settings.ffRate);
+}
+
+//*****************************************************************************
+// saveParams - Saves calibration and tuning to the store. The hover duty is
+// taken from the main rotor if flying. Returns true if saved.
+//*****************************************************************************
+static bool
+saveParams (void)
+{
+    settings_t settings;
+
+    if (paramHeli->heliState == FLYING)
+    {
+        paramHeli->hoverDuty = paramHeli->mainRotor->duty;
+    }
+
+    settings.altZero = paramHeli->altZero;
+    settings.altRange = paramHeli->altRange;
+    settings.hoverDuty = paramHeli->hoverDuty;
+    getGainTune (AXIS_ALT, &settings.altTune);
+    getGainTune (AXIS_YAW, &settings.yawTune);
+    getTailFeedforward (&settings.ffGain, &settings.ffOffset, &settings.ffRate);
+    return saveSettings (&settings);
+}
+
+//*****************************************************************************
+// findParam - Returns the index of the named parameter, or -1.
+//*****************************************************************************
+static int16_t
+findParam (const char *name)
+{
+    uint16_t i;
+    for (i = 0; i < NUM_PARAMS; i++)
+    {
+        if (ustrcmp (name, params[i].name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//*****************************************************************************
+// parseInt - Parses a signed decimal integer. Returns true if the whole string
+// is a number.
+//*****************************************************************************
+static bool
+parseInt (const char *str, int32_t *value)
+{
+    const char *end;
+    bool neg = (str[0] == '-');
+
+    *value = ustrtoul (str + neg, &end, 10);
+    if (neg)
+    {
+        *value = -*value;
+    }
+    return (end != str + neg && *end == '\0');
+}
+
+//*****************************************************************************
+// parseValue - Parses and range checks a value for a parameter. Returns true
+// if the whole string is a valid value.
+//*****************************************************************************
+static bool
+parseValue (const param_t *param, const char *str, paramValue_t *value)
+{
+    const char *end;
+    float num;
+
+    if (param->type == PARAM_INT)
+    {
+        if (!parseInt (str, &value->i))
+        {
+            return false;
+        }
+        num = value->i;
+    } else {
+        value->f = ustrtof (str, &end);
+        if (end == str || *end != '\0')
+        {
+            return false;
+        }
+        num = value->f;
+    }
+    return (num >= param->min && num <= param->max);
+}
+
+//*****************************************************************************
+// sendParam - Sends a parameter and its value as name = value.
+//*****************************************************************************
+static void
+sendParam (const param_t *param)
+{
+    char outStr[PARAM_OUT_LEN + 1];
+
+    if (param->type == PARAM_INT)
+    {
+        usnprintf (outStr, sizeof(outStr), "%s = %d\r\n", param->name,
+                   *(int32_t *) param->value);
+    } else {
+        // Print floats as fixed point since usnprintf has no %f.
+        float val = *(float *) param->value;
+        char sign = (val < 0) ? '-' : ' ';
+        uint32_t milli = (uint32_t) ((val < 0 ? -val : val) * 1000 + 0.5f);
+        usnprintf (outStr, sizeof(outStr), "%s =%c%d.%03d\r\n", param->name,
+                   sign, milli / 1000, milli % 1000);
+    }
+    UARTSend (outStr);
+}
+
+//*****************************************************************************
+// setParams - Validates every name and value pair, then stages them all.
+// Nothing is staged if any pair is invalid.
+//*****************************************************************************
+static void
+setParams (char **tokens, uint8_t numTokens)
+{
+    uint8_t index[PARAM_MAX_PENDING];
+    paramValue_t value[PARAM_MAX_PENDING];
+    uint8_t count = numTokens / 2;
+    uint8_t i;
+
+    if (numTokens == 0 || numTokens % 2 != 0 || count > PARAM_MAX_PENDING)
+    {
+        UARTSend ("ERR usage: set <name> <value> ...\r\n");
+        return;
+    }
+    if (pendingCount > 0)
+    {
+        UARTSend ("ERR busy\r\n");
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        int16_t p = findParam (tokens[2 * i]);
+        if (p < 0)
+        {
+            UARTSend ("ERR unknown name\r\n");
+            return;
+        }
+        if (!parseValue (&params[p], tokens[2 * i + 1], &value[i]))
+        {
+            UARTSend ("ERR bad value\r\n");
+            return;
+        }
+        index[i] = p;
+    }
+
+    // Stage the whole set, then publish the count so it is applied together.
+    for (i = 0; i < count; i++)
+    {
+        pendingIndex[i] = index[i];
+        pendingValue[i] = value[i];
+    }
+    pendingCount = count;
+    UARTSend ("OK\r\n");
+}
+
+//*****************************************************************************
+// missionCommand - Edits, arms or stops the mission. The waypoint table can
+// not be changed while a mission is running.
+//*****************************************************************************
+static void
+missionCommand (char **tokens, uint8_t numTokens)
+{
+    char outStr[PARAM_OUT_LEN + 1];
+    int32_t alt, yaw, holdMs;
+
+    if (numTokens == 1 && ustrcmp (tokens[0], "clear") == 0)
+    {
+        UARTSend (clearMission () ? "OK\r\n" : "ERR busy\r\n");
+    }
+    else if (numTokens == 1 && ustrcmp (tokens[0], "default") == 0)
+    {
+        if (missionRunning ())
+        {
+            UARTSend ("ERR busy\r\n");
+        } else {
+            initMission ();
+            UARTSend ("OK\r\n");
+        }
+    }
+    else if (numTokens == 4 && ustrcmp (tokens[0], "add") == 0)
+    {
+        if (!parseInt (tokens[1], &alt) || alt < ALT_MIN_PER || alt > ALT_MAX_PER ||
+                !parseInt (tokens[2], &yaw) || yaw < -180 || yaw > 180 ||
+                !parseInt (tokens[3], &holdMs) || holdMs < 0 || holdMs > MISSION_MAX_HOLD_MS)
+        {
+            UARTSend ("ERR bad value\r\n");
+            return;
+        }
+        waypoint_t wp = {.alt = alt, .yaw = yaw, .holdMs = holdMs};
+        if (!addWaypoint (&wp))
+        {
+            UARTSend ("ERR full or busy\r\n");
+            return;
+        }
+        usnprintf (outStr, sizeof(outStr), "OK %d\r\n", getNumWaypoints ());
+        UARTSend (outStr);
+    }
+    else if (numTokens == 1 && ustrcmp (tokens[0], "start") == 0)
+    {
+        armMission (true);
+        UARTSend (missionArmed () ? "OK\r\n" : "ERR no waypoints\r\n");
+    }
+    else if (numTokens == 1 && ustrcmp (tokens[0], "stop") == 0)
+    {
+        armMission (false);
+        stopMission ();
+        UARTSend ("OK\r\n");
+    }
+    else
+    {
+        UARTSend ("ERR usage: wp clear|default|start|stop, wp add <alt> <yaw> <ms>\r\n");
+    }
+}
+
+//*****************************************************************************
+// initParams - Sets up the parameter store for the helicopter.
+//*****************************************************************************
+void
+initParams (heli_t *heli)
+{
+    paramHeli = heli;
+    pendingCount = 0;
+    listIndex = -1;
+    loadParams ();
+}
+
+//*****************************************************************************
+// handleCommands - Handles a command line received on the UART and sends the
+// reply. Listing sends one parameter per call so the UART is not overloaded.
+//*****************************************************************************
+void
+handleCommands (void)
+{
+    char line[UART_RX_LINE_LEN];
+    char *tokens[2 * PARAM_MAX_PENDING + 2];   // Room to detect too many values
+    uint8_t numTokens = 0;
+    char *c;
+
+    // Report lines lost while commands were not being read, or too long to
+    // take whole, so a script sending several lines knows to resend.
+    if (UARTTakeOverrun ())
+    {
+        UARTSend ("ERR overrun\r\n");
+    }
+    if (UARTTakeTooLong ())
+    {
+        UARTSend ("ERR line too long\r\n");
+    }
+
+    if (listIndex >= 0)
+    {
+        if (listIndex == 0)
+        {
+            refreshParams ();
+        }
+        sendParam (&params[listIndex]);
+        listIndex = (listIndex + 1 < NUM_PARAMS) ? listIndex + 1 : -1;
+        return;
+    }
+
+    if (!UARTGetLine (line))
+    {
+        return;
+    }
+
+    // Split the line into space separated tokens in place.
+    for (c = line; *c; c++)
+    {
+        if (*c == ' ' || *c == '\t')
+        {
+            *c = '\0';
+        }
+        else if ((c == line || *(c - 1) == '\0') && numTokens < sizeof(tokens) / sizeof(tokens[0]))
+        {
+            tokens[numTokens++] = c;
+        }
+    }
+    if (numTokens == 0)
+    {
+        return;
+    }
+
+    if (ustrcmp (tokens[0], "list") == 0)
+    {
+        listIndex = 0;
+    }
+    else if (ustrcmp (tokens[0], "get") == 0 && numTokens == 2)
+    {
+        int16_t p = findParam (tokens[1]);
+        if (p < 0)
+        {
+            UARTSend ("ERR unknown name\r\n");
+        } else {
+            refreshParams ();
+            sendParam (&params[p]);
+        }
+    }
+    else if (ustrcmp (tokens[0], "set") == 0)
+    {
+        setParams (&tokens[1], numTokens - 1);
+    }
+    else if (ustrcmp (tokens[0], "save") == 0)
+    {
+        UARTSend (saveParams () ? "OK\r\n" : "ERR save failed\r\n");
+    }
+    else if (ustrcmp (tokens[0], "wp") == 0)
+    {
+        missionCommand (&tokens[1], numTokens - 1);
+    }
+    else
+    {
+        UARTSend ("ERR commands: list, get, set, save, wp\r\n");
+    }
+}
+
+//*****************************************************************************
+// applyParams - Applies all values staged by the last set command. Each apply
+// function runs once after all the values are written.
+//*****************************************************************************
+void
+applyParams (void)
+{
+    void (*applied[PARAM_MAX_PENDING])(void);
+    uint8_t numApplied = 0;
+    uint8_t i, j;
+
+    if (pendingCount == 0)
+    {
+        return;
+    }
+
+    // Fill in the copies of other modules' values so unchanged ones are kept.
+    refreshParams ();
+
+    for (i = 0; i < pendingCount; i++)
+    {
+        const param_t *param = &params[pendingIndex[i]];
+        if (param->type == PARAM_INT)
+        {
+            *(int32_t *) param->value = pendingValue[i].i;
+        } else {
+            *(float *) param->value = pendingValue[i].f;
+        }
+
+        // Note each apply function once.
+        bool seen = (param->apply == NULL);
+        for (j = 0; j < numApplied; j++)
+        {
+            if (applied[j] == param->apply)
+            {
+                seen = true;
+            }
+        }
+        if (!seen)
+        {
+            applied[numApplied++] = param->apply;
+        }
+    }
+
+    for (i = 0; i < numApplied; i++)
+    {
+        applied[i] ();
+    }
+    pendingCount = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef PARAMS_H_
+#define PARAMS_H_
+
+// *******************************************************
+//
+// params.h
+//
+// Runtime parameter store with a UART command interface.
+// Parameters are named, typed and range checked, and can be
+// read with get and list or changed with set. Values from a
+// set are staged and applied together at the start of the
+// next controller update. Calibration and tuning can be saved
+// to the settings store and are loaded at start up.
+//
+// Commands, one per line:
+//   list                       Lists all parameters
+//   get <name>                 Reads a parameter
+//   set <name> <value> ...     Sets one or more parameters
+//   save                       Saves calibration and tuning
+//   wp add <alt> <yaw> <ms>    Adds a mission waypoint
+//   wp clear                   Removes all mission waypoints
+//   wp default                 Loads the default mission
+//   wp start                   Runs the mission once flying
+//   wp stop                    Stops or disarms the mission
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stateMachine.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define PARAM_RATE          25      // Rate commands are handled at in Hz
+#define PARAM_MAX_PENDING   8       // Most values in one set command
+#define PARAM_OUT_LEN       40      // Longest reply line
+
+//*****************************************************************************
+// initParams - Sets up the parameter store for the helicopter and applies any
+// saved settings. Call after initStore.
+//*****************************************************************************
+void
+initParams (heli_t *heli);
+
+//*****************************************************************************
+// handleCommands - Handles a command line received on the UART and sends the
+// reply. Listing sends one parameter per call. Call at PARAM_RATE.
+//*****************************************************************************
+void
+handleCommands (void);
+
+//*****************************************************************************
+// applyParams - Applies all values staged by the last set command. Call at the
+// start of the controller update so no update sees a partial set.
+//*****************************************************************************
+void
+applyParams (void);
+
+#endif /* PARAMS_H_ */
@@ -2,7 +2,11 @@
 //
 // stateMachine.c
 //
-// Finite state machine state definitions and function module
+// Finite state machine state definitions and function module.
+// States are table driven, with a parent for shared
+// transitions, entry and exit actions run once on a change,
+// and a run function for each update. Transitions are taken
+// in table order when their guard is true and are logged.
 //
 // Author:  Zeb Barry           ID: 79313790
 // Author:  Mitchell Hollows    ID: 23567059
@@ -14,34 +18,87 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include "stateMachine.h"
 #include "buttons4.h"
 #include "motorControl.h"
 #include "yaw.h"
 #include "heliPWM.h"
+#include "motorOutput.h"
+#include "tailCal.h"
+#include "autotune.h"
+#include "heliADC.h"
+#include "heliHealth.h"
+#include "altEstimator.h"
+#include "trajectory.h"
+#include "mission.h"
+
+//********************************************************
+// Types
+//********************************************************
+typedef struct {
+    uint8_t parent;                 // Enclosing state, or STATE_ROOT
+    void (*entry)(heli_t *heli);    // Run once on entering the state, or NULL
+    void (*exit)(heli_t *heli);     // Run once on leaving the state, or NULL
+    void (*run)(heli_t *heli);      // Run every update while in the state, or NULL
+} stateDef_t;
+
+typedef struct {
+    uint8_t from;                   // State, or parent of states, the row applies in
+    uint8_t to;
+    bool (*guard)(heli_t *heli);    // Transition is taken when this is true
+    void (*action)(heli_t *heli);   // Run between the exit and entry actions, or NULL
+} transition_t;
+
+//********************************************************
+// Globals
+//********************************************************
+int32_t altStepPer = ALT_STEP_PER;
+int32_t yawStepDeg = YAW_STEP_DEG;
+
+static heli_t *smHeli;
+static volatile bool touchdown = false;    // Set by the ground comparator while landing
+static enum butStates swEvent;             // Last switch change not yet acted on
+static enum tuneStatus tuneState;          // Result of the last autotune update
+static uint32_t stateTicks;                // Updates since start up
+
+// Transition log, a ring of the last STATE_LOG_LEN transitions
+static stateLog_t stateLog[STATE_LOG_LEN];
+static uint32_t logWrite;
+static uint32_t logRead;
 
 
 //********************************************************
 // updateDesiredAlt - Updates desired altitude value
 //********************************************************
 int16_t
-updateDesiredAlt(int16_t desiredAlt)
+updateDesiredAlt(int16_t desiredAlt, uint8_t butName)
 {
     // Increase desired altitude if UP button pressed.
-    if (checkButton(UP) == PUSHED && desiredAlt < ALT_MAX_PER)
+    if (butName == UP && desiredAlt < ALT_MAX_PER)
     {
-        desiredAlt += ALT_STEP_PER;
+        desiredAlt += altStepPer;
         // Reset integral
         altErrorInt = 0;
     }
 
     // Decrease desired altitude if DOWN button pressed.
-    if (checkButton(DOWN) == PUSHED && desiredAlt > ALT_MIN_PER)
+    if (butName == DOWN && desiredAlt > ALT_MIN_PER)
     {
-        desiredAlt -= ALT_STEP_PER;
+        desiredAlt -= altStepPer;
         // Reset integral
         altErrorInt = 0;
     }
+
+    // Stop at the limits when the step does not divide the range.
+    if (desiredAlt > ALT_MAX_PER)
+    {
+        desiredAlt = ALT_MAX_PER;
+    }
+    else if (desiredAlt < ALT_MIN_PER)
+    {
+        desiredAlt = ALT_MIN_PER;
+    }
     return desiredAlt;
 }
 
@@ -49,124 +106,598 @@ updateDesiredAlt(int16_t desiredAlt)
 // updateDesiredYaw - Updates desired yaw value
 //********************************************************
 int32_t
-updateDesiredYaw(int32_t desiredYaw)
+updateDesiredYaw(int32_t desiredYaw, uint8_t butName)
 {
     // Increase desired yaw if RIGHT button pressed.
-    if (checkButton(RIGHT) == PUSHED)
+    if (butName == RIGHT)
     {
-        desiredYaw += YAW_STEP_DEG;
+        desiredYaw += yawStepDeg;
         // Reset integral
         yawErrorInt = 0;
     }
 
     // Decrease desired yaw if LEFT button pressed.
-    if (checkButton(LEFT) == PUSHED)
+    if (butName == LEFT)
     {
-        desiredYaw -= YAW_STEP_DEG;
+        desiredYaw -= yawStepDeg;
         // Reset integral
         yawErrorInt = 0;
     }
-    return desiredYaw;
+
+    // Keep desired yaw within -180 to 180 so it never accumulates turns.
+    return mapYaw2Deg(desiredYaw, true);
+}
+
+//********************************************************
+// updateDispMode - Selects text or scope display with UP and DOWN
+//********************************************************
+enum dispMode
+updateDispMode(enum dispMode dispMode, uint8_t butName)
+{
+    // Show altitude and yaw error scope if UP button pressed.
+    if (butName == UP)
+    {
+        dispMode = SCOPE_DISP;
+    }
+
+    // Show text status display if DOWN button pressed.
+    if (butName == DOWN)
+    {
+        dispMode = TEXT_DISP;
+    }
+    return dispMode;
+}
+
+//********************************************************
+// handleButtons - Takes all queued button events and applies
+// them for the current state. Events in other states are
+// discarded so they do not act later.
+//********************************************************
+void
+handleButtons(heli_t *heli)
+{
+    butEvent_t event;
+
+    while (getButtonEvent (&event))
+    {
+        switch (heli->heliState)
+        {
+        // LANDED - UP and DOWN select display mode. Holding LEFT
+        //          runs a tail feedforward calibration on the next flight,
+        //          holding RIGHT arms or disarms autotuning.
+        case LANDED:
+            if (event.type == BUT_PUSHED)
+            {
+                heli->dispMode = updateDispMode (heli->dispMode, event.butName);
+            }
+            else if (event.type == BUT_LONG_PRESS && event.butName == LEFT)
+            {
+                startTailCal ();
+            }
+            else if (event.type == BUT_LONG_PRESS && event.butName == RIGHT)
+            {
+                armAutotune (!autotuneArmed ());
+            }
+            break;
+
+        // FLYING - Each push or repeat from holding a button steps
+        //          the desired position, unless calibrating. Buttons are
+        //          ignored in MISSION so every run is the same.
+        case FLYING:
+            if ((event.type == BUT_PUSHED || event.type == BUT_REPEAT) && !tailCalRunning ())
+            {
+                heli->desiredAlt = updateDesiredAlt (heli->desiredAlt, event.butName);
+                heli->desiredYaw = updateDesiredYaw (heli->desiredYaw, event.butName);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+
+//********************************************************
+// setpointErrors - Moves the setpoint trajectories on
+// towards the desired position and finds the altitude and
+// yaw errors from them.
+//********************************************************
+static void
+setpointErrors (heli_t *heli, int32_t *altError, int32_t *yawError)
+{
+    *altError = calcAltError (updateTraj (&heli->altTraj, heli->desiredAlt, CONTROLLER_DT),
+                              getAltEstimate ());
+    *yawError = calcYawError (YAW_FDEG2ANGLE(updateTraj (&heli->yawTraj, heli->desiredYaw,
+                                                         CONTROLLER_DT)), getYawAngle ());
+}
+
+//********************************************************
+// Entry and exit actions
+//********************************************************
+static void
+enterLanded (heli_t *heli)
+{
+    // Ramp motors down and turn off, and look for the reference again.
+    setRotorEnable (heli->mainRotor, false);
+    setRotorEnable (heli->tailRotor, false);
+    heli->desiredAlt = 0;
+    touchdown = false;
+    yawRefIntEnable ();
 }
 
+static void
+enterAirborne (heli_t *heli)
+{
+    // Soft start motors. They stay on until LANDED is entered.
+    setRotorEnable (heli->mainRotor, true);
+    setRotorEnable (heli->tailRotor, true);
+}
+
+static void
+enterTakingOff (heli_t *heli)
+{
+    // Hover low while rotating to find the yaw reference.
+    setRotorTarget (heli->mainRotor, DUTY_PER2Q16(PWM_MIN_MAIN));
+    setRotorTarget (heli->tailRotor, DUTY_PER2Q16(ROTATE_DUTY_TAIL));
+    hitYawRef = false;
+}
+
+static void
+exitTakingOff (heli_t *heli)
+{
+    yawRefIntDisable ();
+    hitYawRef = false;
+}
+
+static void
+enterFlying (heli_t *heli)
+{
+    heli->altTraj.maxVel = heli->altRate;
+}
+
+static void
+enterLanding (heli_t *heli)
+{
+    // Whatever was running is stopped and the heli returns to the reference.
+    stopTailCal ();
+    stopAutotune ();
+    stopMission ();
+    heli->desiredAlt = 0;
+    heli->desiredYaw = 0;
+}
 
 //********************************************************
-// landed - Resets motors to off and checks switch
+// Run functions, called every update in their state
 //********************************************************
-enum state
-landed (rotor_t *mainRotor, rotor_t *tailRotor)
+static void
+runTakingOff (heli_t *heli)
+{
+    // Start the setpoints where the heli is so flight begins without a jump.
+    resetTraj (&heli->altTraj, getAltEstimate ());
+    resetTraj (&heli->yawTraj, YAW_ANGLE2DEG(getYawAngle ()));
+}
+
+static void
+runFlying (heli_t *heli)
+{
+    int32_t altError, yawError;
+
+    if (tailCalRunning ())
+    {
+        heli->desiredAlt = updateTailCal (heli->mainRotor->duty, heli->tailRotor->duty);
+    }
+    setpointErrors (heli, &altError, &yawError);
+    scheduleGains (heli->mappedAlt, GAINS_FLYING);
+    fly (heli->mainRotor, heli->tailRotor, altError, yawError);
+}
+
+static void
+runAutotune (heli_t *heli)
 {
-    // If motors are on, turn off.
-    if (mainRotor->state || tailRotor->state)
+    const tuneResult_t *result = getAutotuneResult ();
+    int32_t altError, yawError;
+    uint32_t duty;
+
+    setpointErrors (heli, &altError, &yawError);
+    scheduleGains (heli->mappedAlt, GAINS_FLYING);
+
+    // Relay drives the rotor for the axis under test, PID holds the other.
+    if (result->axis == AXIS_ALT)
+    {
+        tuneState = updateAutotune (altError, &duty);
+        setRotorTarget (heli->mainRotor, duty);
+        yawController (heli->tailRotor, heli->mainRotor, yawError);
+    } else {
+        tuneState = updateAutotune (yawError, &duty);
+        altController (heli->mainRotor, altError);
+        setRotorTarget (heli->tailRotor, duty);
+    }
+
+    // Apply the gains found, then tune yaw once altitude is done.
+    if (tuneState == TUNE_DONE)
     {
-        motorPower (mainRotor, false);
-        motorPower (tailRotor, false);
+        tuneGains (result->axis, &result->gains);
+        if (result->axis == AXIS_ALT)
+        {
+            startAutotune (AXIS_YAW, heli->tailRotor->duty);
+            tuneState = TUNE_RUNNING;
+        }
     }
+}
+
+static void
+runMission (heli_t *heli)
+{
+    waypoint_t wp;
+    int32_t altError, yawError;
 
-    // Check for SW change to trigger state change
-    if (checkButton(SW) == PUSHED)
+    // Fly to the waypoint in progress. The last one is held once it ends.
+    if (updateMission (getAltEstimate (), YAW_ANGLE2DEG(getYawAngle ()), &wp))
     {
-        return TAKING_OFF;
+        heli->desiredAlt = wp.alt;
+        heli->desiredYaw = wp.yaw;
+    }
+    setpointErrors (heli, &altError, &yawError);
+    scheduleGains (heli->mappedAlt, GAINS_FLYING);
+    fly (heli->mainRotor, heli->tailRotor, altError, yawError);
+}
+
+static void
+runLanding (heli_t *heli)
+{
+    int32_t altError, yawError;
+
+    // Descend at LAND_DESCENT_RATE_PER, slowing to LAND_TOUCHDOWN_RATE_PER
+    // below LAND_FLARE_ALT_PER.
+    if (heli->altTraj.pos > LAND_FLARE_ALT_PER)
+    {
+        heli->altTraj.maxVel = LAND_DESCENT_RATE_PER;
     } else {
-        return LANDED;
+        heli->altTraj.maxVel = LAND_TOUCHDOWN_RATE_PER;
+    }
+    setpointErrors (heli, &altError, &yawError);
+    scheduleGains (heli->mappedAlt, GAINS_LANDING);
+    fly (heli->mainRotor, heli->tailRotor, altError, yawError);
+}
+
+//********************************************************
+// Guards
+//********************************************************
+static bool
+switchUp (heli_t *heli)
+{
+    return swEvent == PUSHED;
+}
+
+static bool
+switchDown (heli_t *heli)
+{
+    return swEvent == RELEASED;
+}
+
+static bool
+readyToTakeOff (heli_t *heli)
+{
+    // Wait for the altitude calibration and a working altitude sensor.
+    return switchUp (heli) && !heli->initProg && !(getHealthFaults () & HEALTH_ADC_FAULTS);
+}
+
+static bool
+faulted (heli_t *heli)
+{
+    return getHealthFaults () || heli->mainRotor->fault || heli->tailRotor->fault;
+}
+
+static bool
+foundYawRef (heli_t *heli)
+{
+    return hitYawRef;
+}
+
+static bool
+autotuneReady (heli_t *heli)
+{
+    // Start autotuning once armed and the setpoints have come to rest.
+    return autotuneArmed () && !tailCalRunning () &&
+           heli->altTraj.vel == 0 && heli->yawTraj.vel == 0;
+}
+
+static bool
+autotuneEnded (heli_t *heli)
+{
+    return tuneState == TUNE_DONE || tuneState == TUNE_FAILED;
+}
+
+static bool
+missionReady (heli_t *heli)
+{
+    // Start the mission once armed and the setpoints have come to rest.
+    return missionArmed () && !tailCalRunning () &&
+           heli->altTraj.vel == 0 && heli->yawTraj.vel == 0;
+}
+
+static bool
+missionEnded (heli_t *heli)
+{
+    return !missionRunning ();
+}
+
+static bool
+touchedDown (heli_t *heli)
+{
+    // The ground comparator has already turned the motors off.
+    return touchdown || heli->mappedAlt < heli->landedAlt;
+}
+
+//********************************************************
+// Transition actions
+//********************************************************
+static void
+takeSwitch (heli_t *heli)
+{
+    // The switch change has been acted on.
+    swEvent = NO_CHANGE;
+}
+
+static void
+startFlying (heli_t *heli)
+{
+    if (heli->hoverDuty)
+    {
+        presetAltIntegral (heli->hoverDuty);
+    }
+}
+
+static void
+beginMission (heli_t *heli)
+{
+    startMission ();
+}
+
+static void
+beginAutotune (heli_t *heli)
+{
+    startAutotune (AXIS_ALT, heli->mainRotor->duty);
+    tuneState = TUNE_RUNNING;
+}
+
+//********************************************************
+// State and transition tables
+//********************************************************
+static const stateDef_t states[NUM_STATES] = {
+    [LANDED]     = {STATE_ROOT, enterLanded,    NULL,          NULL},
+    [TAKING_OFF] = {AIRBORNE,   enterTakingOff, exitTakingOff, runTakingOff},
+    [FLYING]     = {AIRBORNE,   enterFlying,    NULL,          runFlying},
+    [LANDING]    = {AIRBORNE,   enterLanding,   NULL,          runLanding},
+    [AUTOTUNE]   = {AIRBORNE,   NULL,           NULL,          runAutotune},
+    [MISSION]    = {AIRBORNE,   NULL,           NULL,          runMission},
+    [AIRBORNE]   = {STATE_ROOT, enterAirborne,  NULL,          NULL},
+};
+
+// Checked in order from the current state then up through its parents. The
+// first row with a true guard is taken. Transitions to the current state are
+// skipped, so the fault row does not restart LANDING.
+static const transition_t transitions[] = {
+    {LANDED,     TAKING_OFF, readyToTakeOff, takeSwitch},
+    {TAKING_OFF, FLYING,     foundYawRef,    startFlying},
+    {FLYING,     LANDING,    switchDown,     takeSwitch},
+    {FLYING,     AUTOTUNE,   autotuneReady,  beginAutotune},
+    {AUTOTUNE,   LANDING,    switchDown,     takeSwitch},
+    {AUTOTUNE,   FLYING,     autotuneEnded,  NULL},
+    {FLYING,     MISSION,    missionReady,   beginMission},
+    {MISSION,    LANDING,    switchDown,     takeSwitch},
+    {MISSION,    FLYING,     missionEnded,   NULL},
+    {LANDING,    LANDED,     touchedDown,    NULL},
+    {AIRBORNE,   LANDING,    faulted,        NULL},
+};
+
+#define NUM_TRANSITIONS     (sizeof(transitions) / sizeof(transitions[0]))
+
+//********************************************************
+// isInState - Returns true if leaf is state or inside it.
+//********************************************************
+static bool
+isInState (uint8_t leaf, uint8_t state)
+{
+    for (; leaf != STATE_ROOT; leaf = states[leaf].parent)
+    {
+        if (leaf == state)
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 //********************************************************
-// takeOff - Orientates helicopter to yawRef
+// logTransition - Adds a transition to the log, dropping
+// the oldest if it is full.
 //********************************************************
-enum state
-takeOff (rotor_t *mainRotor, rotor_t *tailRotor)
+static void
+logTransition (uint8_t from, uint8_t to, uint8_t rule)
 {
-    // Check motors are turned on and with correct duty cycles
-    if (!mainRotor->state || !tailRotor->state ||
-            mainRotor->duty != PWM_MIN_MAIN || tailRotor->duty != ROTATE_DUTY_TAIL)
+    stateLog_t *entry = &stateLog[logWrite % STATE_LOG_LEN];
+
+    entry->timeMs = stateTicks * (1000 / CONTROLLER_RATE);   // Ticks * 1000 would overflow
+    entry->from = from;
+    entry->to = to;
+    entry->rule = rule;
+    logWrite++;
+    if (logWrite - logRead > STATE_LOG_LEN)
     {
-        mainRotor->duty = PWM_MIN_MAIN;
-        tailRotor->duty = ROTATE_DUTY_TAIL;
-        setPWM (mainRotor);
-        setPWM (tailRotor);
-        motorPower (mainRotor, true);
-        motorPower (tailRotor, true);
+        logRead = logWrite - STATE_LOG_LEN;
     }
+}
+
+//********************************************************
+// changeState - Runs exit actions from the current state up
+// to the parent shared with target, then the transition
+// action, then entry actions down to target.
+//********************************************************
+static void
+changeState (heli_t *heli, uint8_t rule)
+{
+    const transition_t *t = &transitions[rule];
+    uint8_t from = heli->heliState;
+    uint8_t path[NUM_STATES];
+    uint8_t depth = 0;
+    uint8_t s;
 
-    // If yaw reference flag is true, change state
-    if (hitYawRef)
+    for (s = from; s != STATE_ROOT && !isInState (t->to, s); s = states[s].parent)
     {
-        yawRefIntDisable();
-        hitYawRef = false;
-        return FLYING;
-    } else {
-        return TAKING_OFF;
+        if (states[s].exit)
+        {
+            states[s].exit (heli);
+        }
+    }
+
+    if (t->action)
+    {
+        t->action (heli);
+    }
+
+    // Enter from the outermost new state down to the target.
+    for (s = t->to; s != STATE_ROOT && !isInState (from, s); s = states[s].parent)
+    {
+        path[depth++] = s;
+    }
+    heli->heliState = (enum state) t->to;
+    while (depth > 0)
+    {
+        s = path[--depth];
+        if (states[s].entry)
+        {
+            states[s].entry (heli);
+        }
+    }
+
+    logTransition (from, t->to, rule);
+}
+
+//********************************************************
+// altLimitHandler - Called from the ADC interrupt while the
+// altitude is past a limit. Turns the motors off on touchdown
+// when landing, and cuts the main rotor back at the ceiling,
+// without waiting for the next controller update.
+//********************************************************
+static void
+altLimitHandler (enum altLimit limit)
+{
+    heli_t *heli = smHeli;
+
+    switch (limit)
+    {
+    case ALT_LIMIT_GROUND:
+        if (heli->heliState == LANDING && heli->altTraj.pos <= LAND_FLARE_ALT_PER &&
+                !touchdown)
+        {
+            motorPower (heli->mainRotor, false);
+            motorPower (heli->tailRotor, false);
+            touchdown = true;
+        }
+        break;
+    case ALT_LIMIT_CEILING:
+        if (heli->mainRotor->duty > DUTY_PER2Q16(PWM_MIN_MAIN))
+        {
+            setDuty (heli->mainRotor, DUTY_PER2Q16(PWM_MIN_MAIN));
+        }
+        break;
+    default:
+        break;
     }
 }
 
 //********************************************************
-// flight - Flys helicopter checking for switch.
+// initStateMachine - Starts heli in LANDED and sets up the
+// interrupt driven touchdown and ceiling checks.
+//********************************************************
+void
+initStateMachine (heli_t *heli)
+{
+    smHeli = heli;
+    swEvent = NO_CHANGE;
+    stateTicks = 0;
+    logRead = logWrite = 0;
+    heli->heliState = LANDED;
+    enterLanded (heli);
+    setAltLimitHandler (altLimitHandler);
+}
+
+//********************************************************
+// updateStateMachine - Runs the controllers for the current
+// state, then takes the first transition whose guard is true,
+// running the exit and entry actions. Call at CONTROLLER_RATE.
 //********************************************************
-enum state
-flight (rotor_t *mainRotor, rotor_t *tailRotor, int32_t altError, int32_t yawError)
+void
+updateStateMachine (heli_t *heli)
 {
-    // Check if motors are on.
-    if (!mainRotor->state || !tailRotor->state)
+    enum butStates sw = checkButton (SW);
+    uint8_t s;
+    uint8_t rule;
+
+    // Keep a switch change until a transition takes it, so one made while
+    // a state is not looking for it still acts when it is.
+    if (sw != NO_CHANGE)
     {
-        motorPower (mainRotor, true);
-        motorPower (tailRotor, true);
+        swEvent = sw;
     }
+    stateTicks++;
 
-    // Fly helicopter, controlling motors using PID control from error values.
-    fly (mainRotor, tailRotor, altError, yawError);
+    if (states[heli->heliState].run)
+    {
+        states[heli->heliState].run (heli);
+    }
 
-    // If SW changed to down, land heli.
-    if (checkButton(SW) == RELEASED)
+    for (s = heli->heliState; s != STATE_ROOT; s = states[s].parent)
     {
-        return LANDING;
-    } else {
-        return FLYING;
+        for (rule = 0; rule < NUM_TRANSITIONS; rule++)
+        {
+            if (transitions[rule].from == s && transitions[rule].to != heli->heliState &&
+                    transitions[rule].guard (heli))
+            {
+                changeState (heli, rule);
+                return;
+            }
+        }
     }
 }
 
 //********************************************************
-// land - Lands helicopter at reference angle.
+// takeStateLog - Gets the oldest transition not yet taken
+// from the log. Returns false if there are none.
 //********************************************************
-enum state
-land (rotor_t *mainRotor, rotor_t *tailRotor, int32_t altError, int32_t yawError, int16_t mappedAlt)
+bool
+takeStateLog (stateLog_t *entry)
 {
-    // Check if motors are on.
-    if (!mainRotor->state || !tailRotor->state)
+    if (logRead == logWrite)
     {
-        motorPower (mainRotor, true);
-        motorPower (tailRotor, true);
+        return false;
     }
+    *entry = stateLog[logRead % STATE_LOG_LEN];
+    logRead++;
+    return true;
+}
 
-    // Fly helicopter, controlling motors using PID control from error values.
-    fly (mainRotor, tailRotor, altError, yawError);
+//********************************************************
+// updateAltLimits - Sets the touchdown and ceiling limits
+// from the altitude calibration of heli.
+//********************************************************
+void
+updateAltLimits (const heli_t *heli)
+{
+    // Readings fall as the heli climbs, from altZero on the ground.
+    int32_t ground = heli->altZero - (int32_t) heli->landedAlt * heli->altRange / 100;
+    int32_t ceiling = heli->altZero - (int32_t) ALT_CEILING_PER * heli->altRange / 100;
+    int32_t hyst = ALT_LIMIT_HYST_SIGMAS * heli->altNoise;
 
-    // If altitude falls to below 2%, change to landed state
-    if (mappedAlt < 2)
+    if (hyst < ALT_LIMIT_MIN_HYST)
     {
-        yawRefIntEnable();
-        return LANDED;
-    } else
-        return LANDING;
+        hyst = ALT_LIMIT_MIN_HYST;
+    }
+    if (ceiling < 0)
+    {
+        ceiling = 0;
+    }
+    setAltLimits (ground, ceiling, hyst);
 }
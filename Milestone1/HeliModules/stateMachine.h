@@ -18,6 +18,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "heliPWM.h"
+#include "yaw.h"
+#include "trajectory.h"
 
 //********************************************************
 // Constants
@@ -27,57 +29,116 @@
 #define ALT_STEP_PER        10
 #define YAW_STEP_DEG        15
 
+//---Setpoint trajectory limits
+#define ALT_RATE_PER        20      // Max altitude setpoint rate in %/s
+#define ALT_ACCEL_PER       40      // Max altitude setpoint acceleration in %/s^2
+#define YAW_TURN_RATE_DEG   90      // Max yaw setpoint turn rate in deg/s
+#define YAW_TURN_ACCEL_DEG  180     // Max yaw setpoint acceleration in deg/s^2
+#define LAND_DESCENT_RATE_PER   10  // Landing descent rate in %/s
+#define LAND_TOUCHDOWN_RATE_PER 3   // Landing descent rate below LAND_FLARE_ALT_PER in %/s
+#define LAND_FLARE_ALT_PER      15  // Altitude to slow to touchdown rate at
+#define LANDED_ALT_PER          2   // Altitude below which the heli has landed
+#define LANDED_NOISE_SIGMAS     3   // Altitude noise allowed for when detecting landing
+
+//---Altitude limits watched by the ADC comparators
+#define ALT_CEILING_PER         (ALT_MAX_PER + 5)   // Altitude the main rotor is cut back above
+#define ALT_LIMIT_HYST_SIGMAS   3   // Altitude noise a limit must be cleared by
+#define ALT_LIMIT_MIN_HYST      8   // Least limit hysteresis in ADC counts
+
+#define STATE_ROOT              NUM_STATES  // Parent of the top level states
+#define STATE_LOG_LEN           16  // Transitions kept in the log
+
 //********************************************************
 // Globals
 //********************************************************
-enum state {LANDED = 0, TAKING_OFF, FLYING, LANDING};
+// Leaf states first so they index the state names. AIRBORNE is the parent
+// of every state with the motors on and is never the current state.
+enum state {LANDED = 0, TAKING_OFF, FLYING, LANDING, AUTOTUNE, MISSION, AIRBORNE, NUM_STATES};
+enum dispMode {TEXT_DISP = 0, SCOPE_DISP};
 enum state heliState;
+extern int32_t altStepPer;     // Altitude change per button push in %
+extern int32_t yawStepDeg;     // Yaw change per button push in degrees
 typedef struct heli_struct_t
 {
     rotor_t *mainRotor;
     rotor_t *tailRotor;
     bool    initProg;
     int32_t mappedAlt;
-    int32_t mappedYaw;
+    uint16_t altZero;       // ADC reading at landed altitude
+    uint16_t altRange;      // ADC change from landed to full altitude, 0 until calibrated
+    uint32_t hoverDuty;     // Main duty to hover (Q16), 0 if not known
+    float   altNoise;       // Std dev of a single altitude sample in ADC counts
+    int16_t landedAlt;      // Altitude below which the heli has landed
+    yawAngle_t yawAngle;
     int16_t desiredAlt;
-    int32_t desiredYaw;
+    int32_t desiredYaw;     // Target yaw in degrees, -180 to 180
+    traj_t  altTraj;        // Altitude setpoint trajectory used by controller
+    float   altRate;        // Altitude setpoint rate limit when flying in %/s
+    traj_t  yawTraj;        // Yaw setpoint trajectory in degrees used by controller
     enum state heliState;
+    enum dispMode dispMode;
 } heli_t;
 
+typedef struct {
+    uint32_t timeMs;        // Time of the transition since start up
+    uint8_t from;           // enum state left
+    uint8_t to;             // enum state entered
+    uint8_t rule;           // Transition table row taken
+} stateLog_t;
+
 //********************************************************
 // updateDesiredAlt - Updates desired altitude value
 //********************************************************
 int16_t
-updateDesiredAlt(int16_t desiredAlt);
+updateDesiredAlt(int16_t desiredAlt, uint8_t butName);
 
 //********************************************************
 // updateDesiredYaw - Updates desired yaw value
 //********************************************************
 int32_t
-updateDesiredYaw(int32_t desiredYaw);
+updateDesiredYaw(int32_t desiredYaw, uint8_t butName);
+
+//********************************************************
+// updateDispMode - Selects text or scope display with UP and DOWN
+//********************************************************
+enum dispMode
+updateDispMode(enum dispMode dispMode, uint8_t butName);
+
+//********************************************************
+// handleButtons - Takes all queued button events and applies
+// them for the current state. Events in other states are
+// discarded so they do not act later.
+//********************************************************
+void
+handleButtons(heli_t *heli);
 
 //********************************************************
-// landed - Resets motors to off and checks switch
+// initStateMachine - Starts heli in LANDED and sets up the
+// interrupt driven touchdown and ceiling checks.
 //********************************************************
-enum state
-landed (rotor_t *mainRotor, rotor_t *tailRotor);
+void
+initStateMachine (heli_t *heli);
 
 //********************************************************
-// takeOff - Orientates helicopter to yawRef
+// updateStateMachine - Runs the controllers for the current
+// state, then takes the first transition whose guard is true,
+// running the exit and entry actions. Call at CONTROLLER_RATE.
 //********************************************************
-enum state
-takeOff (rotor_t *mainRotor, rotor_t *tailRotor);
+void
+updateStateMachine (heli_t *heli);
 
 //********************************************************
-// flight - Flys helicopter checking for switch.
+// takeStateLog - Gets the oldest transition not yet taken
+// from the log. Returns false if there are none.
 //********************************************************
-enum state
-flight (rotor_t *mainRotor, rotor_t *tailRotor, int32_t altError, int32_t yawError);
+bool
+takeStateLog (stateLog_t *entry);
 
 //********************************************************
-// land - Lands helicopter at reference angle.
+// updateAltLimits - Sets the touchdown and ceiling limits
+// from the altitude calibration of heli.
 //********************************************************
-enum state
-land (rotor_t *mainRotor, rotor_t *tailRotor, int32_t altError, int32_t yawError, int16_t mappedAlt);
+void
+updateAltLimits (const heli_t *heli);
 
 #endif /* STATEMACHINE_H_ */
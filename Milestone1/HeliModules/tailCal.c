@@ -0,0 +1,144 @@
+// *******************************************************
+//
+// tailCal.c
+//
+// Main to tail rotor feedforward calibration. Sweeps the
+// desired altitude through a set of hover levels while the
+// yaw controller holds heading, then fits the settled tail
+// duty against main duty to set the feedforward.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tailCal.h"
+#include "motorControl.h"
+#include "heliPWM.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define SETTLE_TICKS    (TAIL_CAL_SETTLE_MS * CONTROLLER_RATE / 1000)
+#define SAMPLE_TICKS    (TAIL_CAL_SAMPLE_MS * CONTROLLER_RATE / 1000)
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static const int16_t calLevels[] = TAIL_CAL_LEVELS;
+static bool calRunning = false;
+static uint8_t calLevel;
+static uint16_t calTicks;
+static uint32_t calN;
+static float calSumX, calSumY, calSumXX, calSumXY;
+static float calMinX, calMaxX;
+
+//*****************************************************************************
+// fitTailCal - Least squares fit of tail duty = gain * main duty + offset over
+// the sampled duties. The rate gain is kept since a steady sweep cannot
+// measure it. The fit is discarded if the main duty did not vary enough.
+//*****************************************************************************
+static void
+fitTailCal (void)
+{
+    float gain, offset, rateGain;
+    float det = calN * calSumXX - calSumX * calSumX;
+
+    if (calN == 0 || calMaxX - calMinX < TAIL_CAL_MIN_SPREAD || det <= 0)
+    {
+        return;
+    }
+
+    getTailFeedforward (&gain, &offset, &rateGain);
+    gain = (calN * calSumXY - calSumX * calSumY) / det;
+    offset = (calSumY - gain * calSumX) / calN;
+    setTailFeedforward (gain, offset, rateGain);
+}
+
+//*****************************************************************************
+// startTailCal - Starts a calibration sweep on the next update.
+//*****************************************************************************
+void
+startTailCal (void)
+{
+    calRunning = true;
+    calLevel = 0;
+    calTicks = 0;
+    calN = 0;
+    calSumX = calSumY = calSumXX = calSumXY = 0;
+    calMinX = 1;
+    calMaxX = 0;
+}
+
+//*****************************************************************************
+// stopTailCal - Abandons a calibration sweep, leaving the feedforward as is.
+//*****************************************************************************
+void
+stopTailCal (void)
+{
+    calRunning = false;
+}
+
+//*****************************************************************************
+// tailCalRunning - Returns true while a calibration sweep is in progress.
+//*****************************************************************************
+bool
+tailCalRunning (void)
+{
+    return calRunning;
+}
+
+//*****************************************************************************
+// updateTailCal - Steps the calibration sweep with the current rotor duties
+// (Q16) and returns the desired altitude to hover at.
+//*****************************************************************************
+int16_t
+updateTailCal (uint32_t mainDuty, uint32_t tailDuty)
+{
+    int16_t level = calLevels[calLevel];
+
+    if (!calRunning)
+    {
+        return level;
+    }
+
+    // Once settled at this level, sum the duties as fractions of the period.
+    if (calTicks >= SETTLE_TICKS)
+    {
+        float x = (float) mainDuty / DUTY_Q16_ONE;
+        float y = (float) tailDuty / DUTY_Q16_ONE;
+
+        calN++;
+        calSumX += x;
+        calSumY += y;
+        calSumXX += x * x;
+        calSumXY += x * y;
+        if (x < calMinX)
+        {
+            calMinX = x;
+        }
+        if (x > calMaxX)
+        {
+            calMaxX = x;
+        }
+    }
+
+    // Move to the next level, or fit once the last level is sampled.
+    if (++calTicks >= SETTLE_TICKS + SAMPLE_TICKS)
+    {
+        calTicks = 0;
+        if (calLevel + 1 < sizeof(calLevels) / sizeof(calLevels[0]))
+        {
+            calLevel++;
+        } else {
+            calRunning = false;
+            fitTailCal ();
+        }
+    }
+    return level;
+}
@@ -0,0 +1,59 @@
+#ifndef TAILCAL_H_
+#define TAILCAL_H_
+
+// *******************************************************
+//
+// tailCal.h
+//
+// Main to tail rotor feedforward calibration. Sweeps the
+// desired altitude through a set of hover levels while the
+// yaw controller holds heading, then fits the settled tail
+// duty against main duty to set the feedforward.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define TAIL_CAL_LEVELS     {20, 35, 50, 65, 80}    // Hover altitudes swept in %
+#define TAIL_CAL_SETTLE_MS  4000    // Time to settle at each level before sampling
+#define TAIL_CAL_SAMPLE_MS  2000    // Time duties are sampled for at each level
+#define TAIL_CAL_MIN_SPREAD 0.05f   // Min main duty spread for a valid fit, fraction of period
+
+//*****************************************************************************
+// startTailCal - Starts a calibration sweep on the next update.
+//*****************************************************************************
+void
+startTailCal (void);
+
+//*****************************************************************************
+// stopTailCal - Abandons a calibration sweep, leaving the feedforward as is.
+//*****************************************************************************
+void
+stopTailCal (void);
+
+//*****************************************************************************
+// tailCalRunning - Returns true while a calibration sweep is in progress.
+//*****************************************************************************
+bool
+tailCalRunning (void);
+
+//*****************************************************************************
+// updateTailCal - Steps the calibration sweep with the current rotor duties
+// (Q16) and returns the desired altitude to hover at. When the sweep ends the
+// feedforward gain and offset are set from a least squares fit. Call at
+// CONTROLLER_RATE while flying.
+//*****************************************************************************
+int16_t
+updateTailCal (uint32_t mainDuty, uint32_t tailDuty);
+
+#endif /* TAILCAL_H_ */
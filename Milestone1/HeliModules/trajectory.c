@@ -0,0 +1,127 @@
+// *******************************************************
+//
+// trajectory.c
+//
+// Setpoint trajectory generator. Moves a setpoint towards a
+// target along a trapezoidal profile, limiting both the rate
+// and acceleration of the setpoint.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "trajectory.h"
+
+//*****************************************************************************
+// wrapTraj - Wraps a value to within +-wrap/2 if the trajectory is an angle.
+//*****************************************************************************
+static float
+wrapTraj (traj_t *traj, float val)
+{
+    if (traj->wrap > 0)
+    {
+        if (val >= traj->wrap / 2)
+        {
+            val -= traj->wrap;
+        }
+        else if (val < -traj->wrap / 2)
+        {
+            val += traj->wrap;
+        }
+    }
+    return val;
+}
+
+//*****************************************************************************
+// initTraj - Sets the limits for a trajectory and resets it to zero. Set wrap
+// to the units in a full turn for an angle, so it takes the shortest way round
+// and stays within +-wrap/2, or 0 for a linear value.
+//*****************************************************************************
+void
+initTraj (traj_t *traj, float maxVel, float maxAcc, float wrap)
+{
+    traj->maxVel = maxVel;
+    traj->maxAcc = maxAcc;
+    traj->wrap = wrap;
+    resetTraj (traj, 0);
+}
+
+//*****************************************************************************
+// resetTraj - Moves the setpoint straight to pos and stops it.
+//*****************************************************************************
+void
+resetTraj (traj_t *traj, float pos)
+{
+    traj->pos = wrapTraj (traj, pos);
+    traj->vel = 0;
+}
+
+//*****************************************************************************
+// updateTraj - Advances the setpoint by one time step of dt seconds towards
+// target. Returns the new setpoint.
+//*****************************************************************************
+float
+updateTraj (traj_t *traj, float target, float dt)
+{
+    float dist = wrapTraj (traj, target - traj->pos);
+    float accStep = traj->maxAcc * dt;
+
+    // Fastest rate that can still stop at the target, limited to maxVel.
+    // Gives a trapezoidal profile, or triangular for short moves. Braking
+    // from k accSteps moves k(k+1)/2 accStep dt over the steps left, so the
+    // rate is k accSteps rather than the continuous sqrt(2 maxAcc dist),
+    // which arrives still moving and stops in one step.
+    float velWanted = 0;
+    if (accStep > 0)
+    {
+        float k = (sqrtf (1 + 8 * fabsf (dist) / (accStep * dt)) - 1) / 2;
+        velWanted = k * accStep;
+    }
+    if (velWanted > traj->maxVel)
+    {
+        velWanted = traj->maxVel;
+    }
+    if (dist < 0)
+    {
+        velWanted = -velWanted;
+    }
+
+    // Change rate towards the wanted rate, limited by the acceleration.
+    if (velWanted > traj->vel + accStep)
+    {
+        traj->vel += accStep;
+    }
+    else if (velWanted < traj->vel - accStep)
+    {
+        traj->vel -= accStep;
+    }
+    else
+    {
+        traj->vel = velWanted;
+    }
+
+    // Stop at the target rather than overshoot it on the last step, leaving
+    // at most one step's rate so it falls to zero on the next. Only when
+    // moving towards it, so passing through it while turning back slows at
+    // the acceleration limit.
+    if (fabsf (traj->vel * dt) >= fabsf (dist) && (traj->vel * dist) > 0)
+    {
+        traj->pos = wrapTraj (traj, target);
+        if (fabsf (traj->vel) > accStep)
+        {
+            traj->vel = (traj->vel > 0) ? accStep : -accStep;
+        }
+    }
+    else
+    {
+        traj->pos = wrapTraj (traj, traj->pos + traj->vel * dt);
+    }
+    return traj->pos;
+}
@@ -0,0 +1,54 @@
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+// *******************************************************
+//
+// trajectory.h
+//
+// Setpoint trajectory generator. Moves a setpoint towards a
+// target along a trapezoidal profile, limiting both the rate
+// and acceleration of the setpoint.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// *******************************************************
+// Trajectory structure
+typedef struct {
+    float   pos;        // Current setpoint
+    float   vel;        // Current setpoint rate in units/s
+    float   maxVel;     // Rate limit in units/s
+    float   maxAcc;     // Acceleration limit in units/s^2
+    float   wrap;       // Units in a full turn for angles, 0 for no wrapping
+} traj_t;
+
+//*****************************************************************************
+// initTraj - Sets the limits for a trajectory and resets it to zero. Set wrap
+// to the units in a full turn for an angle, so it takes the shortest way round
+// and stays within +-wrap/2, or 0 for a linear value.
+//*****************************************************************************
+void
+initTraj (traj_t *traj, float maxVel, float maxAcc, float wrap);
+
+//*****************************************************************************
+// resetTraj - Moves the setpoint straight to pos and stops it.
+//*****************************************************************************
+void
+resetTraj (traj_t *traj, float pos);
+
+//*****************************************************************************
+// updateTraj - Advances the setpoint by one time step of dt seconds towards
+// target. Returns the new setpoint.
+//*****************************************************************************
+float
+updateTraj (traj_t *traj, float target, float dt);
+
+#endif /* TRAJECTORY_H_ */
@@ -25,8 +25,38 @@
 #include "driverlib/interrupt.h"
 #include "yaw.h"
 #include "display.h"
+#include "heliTimer.h"
 
 
+//*****************************************************************************
+// Quadrature transition table, indexed by (previousState << 2 | currentState).
+// Gives the change in yaw for each transition, with A leading B being CCW.
+// Repeated states and illegal double steps (both pins changing) give zero.
+//*****************************************************************************
+static const int8_t yawTransition[16] = {
+//  curr:  BOTH_ZERO  A_ONE   B_ONE   BOTH_ONE
+           STATIC,    CCW,    CW,     STATIC,   // prev BOTH_ZERO
+           CW,        STATIC, STATIC, CCW,      // prev A_ONE
+           CCW,       STATIC, STATIC, CW,       // prev B_ONE
+           STATIC,    CW,     CCW,    STATIC    // prev BOTH_ONE
+};
+
+// Count of illegal transitions, a measure of encoder health.
+static volatile uint32_t yawIllegalCount;
+
+// Edge timing for yaw rate estimation, written by yawIntHandler.
+static volatile int32_t yawSteps;           // Net steps, not reset by yaw reference
+static volatile uint32_t yawEdgeTime;       // Timer value at last step
+static volatile uint32_t yawEdgePeriod;     // Timer ticks between last two steps, 0 if unknown
+static volatile int8_t yawEdgeDir;          // Direction of last step
+static volatile uint32_t yawEdgeCount;      // Steps in either direction, for health checks
+
+// Yaw rate estimate, written by updateYawRate.
+static float yawRate;                       // Estimated yaw rate in deg/s
+static int32_t yawRateSteps;                // yawSteps at last update
+static uint32_t yawRateTime;                // Timer value at last update
+static uint32_t yawTicksPerSec;             // Timer ticks in a second
+
 //*****************************************************************************
 // yawIntHandler - The handler for the pin change interrupts for pin A and B.
 // Uses quadrature decoding to measure yaw value
@@ -35,51 +65,31 @@ void
 yawIntHandler(void)
 {
     uint32_t intStatus = GPIOIntStatus(YAW_PORT_BASE, true);
+    uint32_t transition;
+    int8_t step;
 
     // Read current pin states
     currentState = GPIOPinRead(YAW_PORT_BASE, YAW_PIN_A | YAW_PIN_B);
 
-    // Check current button states and therefore determine direction based on previous state.
-    switch (currentState)
+    // Look up change in yaw from previous and current pin states, counting
+    // transitions where both pins changed as they have lost a step.
+    transition = (previousState << 2) | currentState;
+    step = yawTransition[transition];
+    yaw += step;
+    yawIllegalCount += (YAW_ILLEGAL_MASK >> transition) & 1;
+    previousState = currentState;
+
+    // Timestamp each step. Period is only valid between steps in the same direction.
+    if (step != STATIC)
     {
-    case BOTH_ZERO:
-        if (previousState == B_ONE)     // A leads
-        {
-            dir = CCW;
-        } else {                        // B leads, etc.
-            dir = CW;
-        }
-        break;
-    case A_ONE:
-        if (previousState == BOTH_ZERO)
-        {
-            dir = CCW;
-        } else {
-            dir = CW;
-        }
-        break;
-    case BOTH_ONE:
-        if (previousState == A_ONE)
-        {
-            dir = CCW;
-        } else {
-            dir = CW;
-        }
-        break;
-    case B_ONE:
-        if (previousState == BOTH_ONE)
-        {
-            dir = CCW;
-        } else {
-            dir = CW;
-        }
-        break;
+        uint32_t now = timerGet();
+        yawEdgePeriod = (step == yawEdgeDir) ? yawEdgeTime - now : 0;  // Timer counts down
+        yawEdgeTime = now;
+        yawEdgeDir = step;
+        yawSteps += step;
+        yawEdgeCount++;
     }
 
-    // Change yaw value by stated direction and save previous button states
-    yaw += dir;
-    previousState = currentState;
-
     // Clear interrupt
     GPIOIntClear(YAW_PORT_BASE, intStatus);
 }
@@ -119,7 +129,8 @@ yawRefIntEnable(void)
 }
 
 //********************************************************
-// initYaw - Initialise yaw pins and register interrupt handlers
+// initYaw - Initialise yaw pins and register interrupt handlers.
+// Call after initTimer.
 //********************************************************
 void
 initYaw (void)
@@ -149,35 +160,144 @@ initYaw (void)
 
     // Set initial state.
     currentState = GPIOPinRead(YAW_PORT_BASE, YAW_PIN_A | YAW_PIN_B);
+    previousState = currentState;
     yaw = 0;
     hitYawRef = false;
-    dir = STATIC;
+    yawIllegalCount = 0;
+
+    // Set initial rate estimate state, timer must already be initialised.
+    yawTicksPerSec = SysCtlClockGet();
+    yawSteps = 0;
+    yawEdgePeriod = 0;
+    yawEdgeDir = STATIC;
+    yawEdgeTime = timerGet();
+    yawRateSteps = 0;
+    yawRateTime = yawEdgeTime;
+    yawRate = 0;
 }
 
 //********************************************************
-// mapYaw2Deg - Maps yaw value from raw input to degrees from range -180 to 180.
+// updateYawRate - Updates yaw rate estimate. Call regularly.
+// Uses the time between the last two encoder edges at slow
+// rotation, or the change in count since the last update when
+// at least YAW_RATE_COUNT_STEPS steps occurred. Falls to zero
+// if no edge occurs within YAW_RATE_TIMEOUT_MS.
 //********************************************************
-int16_t
-mapYaw2Deg(int32_t yawVal, bool alreadyInDeg)
+void
+updateYawRate(void)
 {
-    // Check if already in degrees, otherwise convert
-    if (!alreadyInDeg) {
-        yawVal = YAW_DEG(yawVal);
+    int32_t steps;
+    uint32_t edgeTime, edgePeriod, now;
+    int8_t edgeDir;
+    bool wasMasked;
+
+    // Take a consistent copy of the values written by yawIntHandler. Leave
+    // interrupts masked after if they were on entry.
+    wasMasked = IntMasterDisable();
+    steps = yawSteps;
+    edgeTime = yawEdgeTime;
+    edgePeriod = yawEdgePeriod;
+    edgeDir = yawEdgeDir;
+    now = timerGet();
+    if (!wasMasked)
+    {
+        IntMasterEnable();
     }
 
-    // Reduce yaw value to within one full loop.
-    int16_t scaledYaw = yawVal % DEG_CIRC;
+    uint32_t sinceEdge = edgeTime - now;    // Timer counts down
+    uint32_t sinceUpdate = yawRateTime - now;
+    int32_t counted = steps - yawRateSteps;
 
-    // Restrict range to between -180 to 180
-    int16_t mappedYaw = scaledYaw;
-    if (abs(scaledYaw) > (DEG_CIRC / 2)) {
-        if (scaledYaw > 0) {
-            mappedYaw = scaledYaw - 360;
-        } else
+    if (abs(counted) >= YAW_RATE_COUNT_STEPS)
+    {
+        // Fast rotation, count over the update period is most accurate.
+        yawRate = counted * YAW_DEG_PER_STEP * yawTicksPerSec / sinceUpdate;
+    }
+    else if (sinceEdge > yawTicksPerSec / 1000 * YAW_RATE_TIMEOUT_MS)
+    {
+        // Stationary. Forget the last edge so neither this period nor the
+        // next one measured from the old edge is used once the timer wraps.
+        // Kept if an edge arrived since the copy.
+        yawRate = 0;
+        IntMasterDisable();
+        if (yawEdgeTime == edgeTime)
+        {
+            yawEdgePeriod = 0;
+            yawEdgeDir = STATIC;
+        }
+        if (!wasMasked)
+        {
+            IntMasterEnable();
+        }
+    }
+    else if (edgePeriod == 0)
+    {
+        // Just changed direction.
+        yawRate = 0;
+    }
+    else
+    {
+        // Slow rotation, use the edge period. If the next edge is late the
+        // rate must be slower than one step over the time since the last edge.
+        if (sinceEdge > edgePeriod)
         {
-            mappedYaw = scaledYaw + 360;
+            edgePeriod = sinceEdge;
         }
+        yawRate = edgeDir * YAW_DEG_PER_STEP * yawTicksPerSec / edgePeriod;
     }
-    return mappedYaw;
+
+    yawRateSteps = steps;
+    yawRateTime = now;
 }
 
+//********************************************************
+// getYawRate - Returns latest yaw rate estimate in deg/s,
+// positive in the CW direction.
+//********************************************************
+float
+getYawRate(void)
+{
+    return yawRate;
+}
+
+//********************************************************
+// getYawIllegalCount - Returns number of illegal quadrature
+// transitions (missed steps or glitches) since initialisation.
+//********************************************************
+uint32_t
+getYawIllegalCount(void)
+{
+    return yawIllegalCount;
+}
+
+//********************************************************
+// getYawEdgeCount - Returns number of encoder steps in
+// either direction since initialisation.
+//********************************************************
+uint32_t
+getYawEdgeCount(void)
+{
+    return yawEdgeCount;
+}
+
+//********************************************************
+// getYawAngle - Returns current yaw as a binary angle.
+//********************************************************
+yawAngle_t
+getYawAngle(void)
+{
+    return YAW_TAB2ANGLE(yaw);
+}
+
+//********************************************************
+// mapYaw2Deg - Maps yaw value from raw input to degrees from range -180 to 180.
+//********************************************************
+int16_t
+mapYaw2Deg(int32_t yawVal, bool alreadyInDeg)
+{
+    // Convert to a binary angle, which wraps to within one turn, then to degrees.
+    if (alreadyInDeg) {
+        return YAW_ANGLE2DEG(YAW_DEG2ANGLE(yawVal));
+    }
+    return YAW_ANGLE2DEG(YAW_TAB2ANGLE(yawVal));
+}
@@ -25,8 +25,23 @@
 //*****************************************************************************
 #define YAW_TABS 448      // Number of tabs in a full circle.
 #define DEG_CIRC 360      // Number of degrees in full circle.
-#define YAW_DEG(Y)  (2* Y * DEG_CIRC + YAW_TABS) / 2 / YAW_TABS     // Changes yaw value from number of tabs to degrees
-#define YAW_TAB(Y)  (2 * Y * YAW_TABS + DEG_CIRC) / 2 / DEG_CIRC    // Chnages yaw value from degrees to tabs
+#define YAW_DEG_PER_STEP        ((float) DEG_CIRC / YAW_TABS)       // Degrees per encoder step
+
+//---Yaw angles are binary angles, a full turn is 2^16 so the int16 wraps at +-180 deg
+//   for free. Conversions use a 32 bit multiply by 2^32 / units per turn, then shift.
+//   Integer inputs are first taken within one turn so the error in the rounded
+//   multiplier never grows enough to round the wrong way.
+typedef int16_t yawAngle_t;
+#define YAW_ANGLE_PER_TAB   9586981u    // round(2^32 / YAW_TABS)
+#define YAW_ANGLE_PER_DEG   11930465u   // round(2^32 / DEG_CIRC)
+#define YAW_TAB2ANGLE(T)    ((yawAngle_t) (((uint32_t) ((T) % YAW_TABS) * YAW_ANGLE_PER_TAB + 0x8000) >> 16))   // Tabs to angle
+#define YAW_DEG2ANGLE(D)    ((yawAngle_t) (((uint32_t) ((D) % DEG_CIRC) * YAW_ANGLE_PER_DEG + 0x8000) >> 16))   // Degrees to angle
+#define YAW_ANGLE2DEG(A)    ((int16_t) (((int32_t) (A) * DEG_CIRC + 0x8000) >> 16))              // Angle to degrees
+#define YAW_ANGLE2DDEG(A)   ((int16_t) (((int32_t) (A) * DEG_CIRC * 10 + 0x8000) >> 16))         // Angle to tenths of degrees
+#define YAW_FDEG2ANGLE(D)   ((yawAngle_t) (int32_t) ((D) * (65536.0f / DEG_CIRC)))            // Float degrees to angle
+#define YAW_ANGLE2MDEG(A)   (((int32_t) (A) * (DEG_CIRC * 1000 / 8)) >> 13)                     // Angle to thousandths of degrees
+#define YAW_RATE_COUNT_STEPS    4       // Steps per update above which rate is from count
+#define YAW_RATE_TIMEOUT_MS     250     // Time without an edge before rate is zero
 
 //---Yaw Pin definitions
 #define YAW_PIN_A               GPIO_PIN_0      // PB0
@@ -41,6 +56,9 @@
 enum direction {CCW = -1, STATIC, CW};
 // States of the two pins used for quadrature encoding
 enum yawState {BOTH_ZERO = 0, A_ONE, B_ONE, BOTH_ONE};
+// Bits set for illegal (previousState << 2 | currentState) transitions
+#define YAW_ILLEGAL_MASK    ((1 << (BOTH_ZERO << 2 | BOTH_ONE)) | (1 << (A_ONE << 2 | B_ONE)) | \
+                             (1 << (B_ONE << 2 | A_ONE)) | (1 << (BOTH_ONE << 2 | BOTH_ZERO)))
 
 
 // ****************************************************************************
@@ -50,11 +68,10 @@ volatile int32_t yaw;
 volatile bool hitYawRef;
 volatile static uint32_t currentState;
 volatile static uint32_t previousState;
-volatile static enum direction dir;
 
 //*****************************************************************************
 // yawIntHandler - The handler for the pin change interrupts for pin A and B.
-// Uses quadrature encoding to measure yaw value
+// Uses table driven quadrature decoding to measure yaw value
 //*****************************************************************************
 void
 yawIntHandler(void);
@@ -78,11 +95,48 @@ void
 yawRefIntEnable(void);
 
 //********************************************************
-// initYaw - Initialise yaw pins
+// initYaw - Initialise yaw pins. Call after initTimer.
 //********************************************************
 void
 initYaw (void);
 
+//********************************************************
+// getYawIllegalCount - Returns number of illegal quadrature
+// transitions (missed steps or glitches) since initialisation.
+//********************************************************
+uint32_t
+getYawIllegalCount(void);
+
+//********************************************************
+// getYawEdgeCount - Returns number of encoder steps in
+// either direction since initialisation.
+//********************************************************
+uint32_t
+getYawEdgeCount(void);
+
+//********************************************************
+// updateYawRate - Updates yaw rate estimate. Call regularly.
+// Uses the time between the last two encoder edges at slow
+// rotation, or the change in count since the last update when
+// at least YAW_RATE_COUNT_STEPS steps occurred. Falls to zero
+// if no edge occurs within YAW_RATE_TIMEOUT_MS.
+//********************************************************
+void
+updateYawRate(void);
+
+//********************************************************
+// getYawRate - Returns latest yaw rate estimate in deg/s,
+// positive in the CW direction.
+//********************************************************
+float
+getYawRate(void);
+
+//********************************************************
+// getYawAngle - Returns current yaw as a binary angle.
+//********************************************************
+yawAngle_t
+getYawAngle(void);
+
 //********************************************************
 // mapYaw2Deg - Maps yaw value from raw input to degrees from range -180 to 180.
 //********************************************************
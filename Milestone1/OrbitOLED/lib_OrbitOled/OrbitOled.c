@@ -386,33 +386,54 @@ void
 OrbitOledUpdate()
 	{
 	int		ipag;
-//	int		icol;
-	char *	pb;
-
-	pb = rgbOledBmp;
 
 	for (ipag = 0; ipag < cpagOledMax; ipag++) {
+		OrbitOledUpdatePage(ipag);
+	}
 
-		GPIOPinWrite(nDC_OLEDPort, nDC_OLED, LOW);
+}
 
-		/* Set the page address
-		*/
-		Ssi3PutByte(0x22);		//Set page command
-		Ssi3PutByte(ipag);		//page number
+/* ------------------------------------------------------------ */
+/***	OrbitOledUpdatePage
+**
+**	Parameters:
+**		ipag	- display memory page to copy (0 to cpagOledMax-1)
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Update one 8 row page of the OLED display with the
+**		contents of the matching page of the memory buffer
+*/
 
-		/* Start at the left column
-		*/
-		Ssi3PutByte(0x00);		//set low nibble of column
-		Ssi3PutByte(0x10);		//set high nibble of column
+void
+OrbitOledUpdatePage(int ipag)
+	{
+	char *	pb;
 
-		GPIOPinWrite(nDC_OLEDPort, nDC_OLED, nDC_OLED);
+	pb = &rgbOledBmp[ipag * ccolOledMax];
 
-		/* Copy this memory page of display data.
-		*/
-		OrbitOledPutBuffer(ccolOledMax, pb);
-		pb += ccolOledMax;
+	GPIOPinWrite(nDC_OLEDPort, nDC_OLED, LOW);
 
-	}
+	/* Set the page address
+	*/
+	Ssi3PutByte(0x22);		//Set page command
+	Ssi3PutByte(ipag);		//page number
+
+	/* Start at the left column
+	*/
+	Ssi3PutByte(0x00);		//set low nibble of column
+	Ssi3PutByte(0x10);		//set high nibble of column
+
+	GPIOPinWrite(nDC_OLEDPort, nDC_OLED, nDC_OLED);
+
+	/* Copy this memory page of display data.
+	*/
+	OrbitOledPutBuffer(ccolOledMax, pb);
 
 }
 
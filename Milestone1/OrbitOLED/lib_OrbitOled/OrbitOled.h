@@ -56,6 +56,7 @@
 /*					Variable Declarations						*/
 /* ------------------------------------------------------------ */
 
+extern char	rgbOledBmp[cbOledDispMax];	//offscreen frame buffer
 
 
 /* ------------------------------------------------------------ */
@@ -66,6 +67,7 @@ void	OrbitOledInit();
 void	OrbitOledClear();
 void	OrbitOledClearBuffer();
 void	OrbitOledUpdate();
+void	OrbitOledUpdatePage(int ipag);
 
 /* ------------------------------------------------------------ */
 
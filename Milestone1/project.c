@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <math.h>
 #include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/systick.h"
@@ -32,10 +33,19 @@
 #include "heliADC.h"
 #include "heliPWM.h"
 #include "motorControl.h"
+#include "motorOutput.h"
 #include "stateMachine.h"
 #include "heliHMI.h"
 #include "heliTimer.h"
 #include "kernel.h"
+#include "tailCal.h"
+#include "autotune.h"
+#include "params.h"
+#include "heliStore.h"
+#include "altCal.h"
+#include "altEstimator.h"
+#include "heliHealth.h"
+#include "mission.h"
 
 //*****************************************************************************
 // Constants
@@ -43,7 +53,6 @@
 #define BUF_SIZE            100
 #define SAMPLE_RATE_HZ      1000
 #define DISPLAY_RATE        8
-#define CONTROLLER_RATE     100
 #define ALT_UPDATE_RATE     100
 #define BASE_FREQ           250
 
@@ -52,7 +61,7 @@
 // Global variables
 //*****************************************************************************
 circBuf_t g_inBuffer;               // Buffer of size BUF_SIZE integers (sample values)
-static uint32_t g_ulSampCnt;        // Counter for the interrupts
+static volatile uint32_t g_ulSampCnt;   // Counter for the interrupts
 rotor_t mainRotor;
 rotor_t tailRotor;
 
@@ -65,7 +74,7 @@ sysTickIntHandler(void)
     //
     // Initiate a conversion
     //
-    ADCProcessorTrigger(ADC0_BASE, 3); 
+    ADCProcessorTrigger(ADC0_BASE, ADC_SEQ);
     g_ulSampCnt++;
 
     updateButtons();
@@ -107,36 +116,86 @@ initClock (void)
 
 
 //********************************************************
-// initAltitude - Calibrate height by setting max limit.
+// initAltitude - Calibrate height from the landed samples, or
+// fall back to the saved landed reading if the rig will not
+// settle. Returns true once calibrated. The altitude range and
+// landing threshold allow for the noise found.
 //********************************************************
-uint16_t
-initAltitude (uint16_t altRaw)
+bool
+initAltitude (heli_t *heli)
 {
-    return altRaw - ALT_RANGE;
+    const altCal_t *cal = getAltCal ();
+
+    switch (updateAltCal (&g_inBuffer, g_ulSampCnt))
+    {
+    case ALT_CAL_DONE:
+        heli->altZero = cal->zero;
+        heli->altNoise = cal->noise;
+        break;
+    case ALT_CAL_REJECTED:
+        // Use a saved calibration rather than wait forever.
+        if (cal->rejects >= ALT_CAL_RETRIES && heli->altRange != 0)
+        {
+            heli->altNoise = ALT_CAL_MAX_NOISE;
+            break;
+        }
+        return false;
+    default:
+        return false;
+    }
+
+    if (heli->altRange == 0)
+    {
+        heli->altRange = ALT_RANGE;
+    }
+
+    // Noise on the filtered altitude, in percent, added to the threshold
+    // and used to weight the measurements in the altitude estimate.
+    float filteredNoisePer = heli->altNoise * getAltNoiseGain () * 100 / heli->altRange;
+    heli->landedAlt = LANDED_ALT_PER + (int16_t) ceilf (LANDED_NOISE_SIGMAS * filteredNoisePer);
+    setAltMeasNoise (filteredNoisePer);
+    updateAltLimits (heli);
+    return true;
 }
 
 //********************************************************
-// updateAltTask - Updates altitude value by averaging the samples.
+// updateAltTask - Updates the altitude estimate from the filtered
+// samples and the main rotor duty. The estimate is held at the
+// measured altitude while landed as the ground stops any fall.
 //********************************************************
 static void
 updateAltTask (heli_t *data)
 {
     heli_t *heli = data;
     uint16_t altRaw = 0;
-    static uint16_t inADCMax;
+    float altMeas;
+    float hoverPer;
 
     // If values have been written to the buffer, then calculate the average
     if (g_inBuffer.written)
     {
-        altRaw = calcMean (&g_inBuffer, BUF_SIZE);
-        heli->mappedAlt = mapAlt(altRaw, inADCMax);
-
         // If start of program, calibrate ADC input
         if (heli->initProg)
         {
-            heli->initProg = false;
-            inADCMax = initAltitude(readCircBuf (&g_inBuffer));
+            heli->initProg = !initAltitude (heli);
+            return;
+        }
+
+        altRaw = getAltFiltered ();
+        altMeas = mapAlt (altRaw, heli->altZero, heli->altRange);
+
+        if (heli->heliState == LANDED)
+        {
+            hoverPer = heli->hoverDuty ? (float) heli->hoverDuty * 100 / DUTY_Q16_ONE
+                                       : ALT_EST_HOVER_PER;
+            resetAltEstimator (altMeas, hoverPer);
         }
+        else
+        {
+            updateAltEstimator (altMeas, (float) heli->mainRotor->duty * 100 / DUTY_Q16_ONE,
+                                1.0f / ALT_UPDATE_RATE);
+        }
+        heli->mappedAlt = (int32_t) roundf (getAltEstimate ());
     }
 }
 
@@ -148,73 +207,81 @@ static void
 heliInfoOutputTask (heli_t *data)
 {
     heli_t *heli = data;
+    static bool calShown = false;
+
     if (!heli->initProg)
     {
-        // Heli mappped yaw definition so that display of value is immune to interrupt changes
-        heli->mappedYaw = mapYaw2Deg(yaw, false);
+        // Clear the calibration message before the first update.
+        if (calShown)
+        {
+            displayClear ();
+            calShown = false;
+        }
+        // Heli yaw angle definition so that display of value is immune to interrupt changes
+        heli->yawAngle = getYawAngle();
         handleHMI (heli);
+    } else {
+        displayCalibrating (getAltCal ()->rejects);
+        calShown = true;
     }
 }
 
+//********************************************************
+// commandTask - Handles parameter commands received via UART.
+//********************************************************
+static void
+commandTask (heli_t *data)
+{
+    handleCommands ();
+}
+
+//********************************************************
+// checkHealth - Runs the sensor health checks. The yaw
+// encoder should step and find the reference while taking
+// off.
+//********************************************************
+static void
+checkHealth (heli_t *heli)
+{
+    healthInput_t in = {
+        .adcSamples = getAltSampleCount (),
+        .adcRaw = getAltRaw (),
+        .yawEdges = getYawEdgeCount (),
+        .rotating = heli->heliState == TAKING_OFF &&
+                    heli->tailRotor->duty >= DUTY_PER2Q16(ROTATE_DUTY_TAIL),
+        .findingRef = heli->heliState == TAKING_OFF
+    };
+
+    updateHealth (&in);
+}
+
 //********************************************************
 // stateMachineTask - Controls helicopter state, using PID
 // control to hold altitude and yaw at desired values.
-// Lands and takes off helicopter depending on state of switch.
+// Lands and takes off helicopter depending on state of switch,
+// and lands if a sensor or rotor fault is found.
 //********************************************************
 static void
 stateMachineTask (heli_t *data)
 {
     heli_t *heli = data;
-    int32_t yawError;
-    int32_t altError;
 
-    // FSM for different helicopter states.
-    // Uses switch inputs, orientation and elevation to control
-    // helicopter state.
-    switch (heli->heliState)
-    {
-    // LANDED - Turn motors off, check for upwards SW change to
-    //          move to TAKING_OFF
-    case LANDED:    // Turn motors off and check for SW change
-        heli->desiredAlt = 0;
-        heli->heliState = landed (heli->mainRotor, heli->tailRotor);
-        break;
-
-    // TAKING_OFF - Turn on motors and rotate until yaw reference
-    //              point found then switch to FLYING. Disable yawRefInt
-    //              once state changes.
-    case TAKING_OFF:    // Hover and find yaw ref
-        heli->heliState = takeOff (heli->mainRotor, heli->tailRotor);
-        break;
-
-    // FLYING - Control heli height and yaw using PID control,
-    //          adjusting desired position based on button inputs.
-    //          Change to LANDING when SW move to down.
-    case FLYING:    // Fly to desired position and check for SW change
-        heli->desiredAlt = updateDesiredAlt (heli->desiredAlt);
-        heli->desiredYaw = updateDesiredYaw (heli->desiredYaw);
-        altError = calcAltError(heli->desiredAlt, heli->mappedAlt);
-        yawError = calcYawError(heli->desiredYaw, yaw);
-        heli->heliState = flight (heli->mainRotor, heli->tailRotor, altError, yawError);
-
-        if (heli->heliState == LANDING)
-        {
-            heli->desiredYaw = 0;
-        }
-        break;
-
-    // LANDING - Reduce desired height by DROP_ALT_STEP at 8Hz,
-    //           maintaining desired yaw of 0.
-    //           Move to LANDED once altitude is within 2%.
-    case LANDING:   // Land Heli and change to LANDED once alt < 1%
-        if (heli->desiredAlt - DROP_ALT_STEP > 0) {
-            heli->desiredAlt = heli->desiredAlt - DROP_ALT_STEP;
-        }
-        altError = calcAltError(heli->desiredAlt, heli->mappedAlt);
-        yawError = calcYawError(heli->desiredYaw, YAW_DEG(yaw));
-        heli->heliState = land (heli->mainRotor, heli->tailRotor, altError, yawError, heli->mappedAlt);
-        break;
-    }
+    // Apply parameter changes and button pushes queued since the last update.
+    applyParams ();
+    handleButtons (heli);
+    updateYawRate ();
+    checkHealth (heli);
+
+    // Run the controllers for the current state and change state if needed.
+    updateStateMachine (heli);
+
+    // Ramp rotors towards the duty cycles set above, scaled for the supply.
+    updateSupplyComp (heli->mainRotor, getSupplyMv ());
+    updateSupplyComp (heli->tailRotor, getSupplyMv ());
+    updateMotorOutput (heli->mainRotor);
+    updateMotorOutput (heli->tailRotor);
+    checkRotorCurrent (heli->mainRotor, getRotorCurrent (MAIN));
+    checkRotorCurrent (heli->tailRotor, getRotorCurrent (TAIL));
 }
 
 
@@ -226,7 +293,9 @@ main(void)
 
     initButtons ();
     initClock ();
+    initStore ();
     initTimer ();
+    initAltFilter (SAMPLE_RATE_HZ);
     initADC ();
     initYaw ();
     initDisplay ();
@@ -234,6 +303,8 @@ main(void)
     initCircBuf (&g_inBuffer, BUF_SIZE);
     initPWMMain (&mainRotor); // Initialise motors with set freq and duty cycle
     initPWMTail (&tailRotor);
+    initMotorOutput (&mainRotor, MAIN_SLEW_PER_S);
+    initMotorOutput (&tailRotor, TAIL_SLEW_PER_S);
 
     // Enable interrupts to the processor.
     IntMasterEnable();
@@ -244,17 +315,33 @@ main(void)
        .tailRotor = &tailRotor,
        .initProg = true,
        .mappedAlt = 0,
-       .mappedYaw = 0,
+       .altZero = 0,
+       .altRange = 0,
+       .hoverDuty = 0,
+       .altNoise = 0,
+       .landedAlt = LANDED_ALT_PER,
+       .yawAngle = 0,
        .desiredAlt = 0,
        .desiredYaw = 0,
-       .heliState = LANDED
+       .altRate = ALT_RATE_PER,
+       .heliState = LANDED,
+       .dispMode = TEXT_DISP
     };
 
+    initTraj (&heli.altTraj, ALT_RATE_PER, ALT_ACCEL_PER, 0);
+    initTraj (&heli.yawTraj, YAW_TURN_RATE_DEG, YAW_TURN_ACCEL_DEG, DEG_CIRC);
+    initParams (&heli);
+    initStateMachine (&heli);
+    resetHealth ();
+    initMission ();
+    startAltCal ();
+
     // Define tasks for the scheduler and their frequencies
     task_t tasks[] = {
           {.handler = stateMachineTask, .data = &heli, .updateFreq = CONTROLLER_RATE},
           {.handler = updateAltTask, .data = &heli, .updateFreq = ALT_UPDATE_RATE},
           {.handler = heliInfoOutputTask, .data = &heli, .updateFreq = DISPLAY_RATE},
+          {.handler = commandTask, .data = &heli, .updateFreq = PARAM_RATE},
           {0}   // Null terminator
     };
 
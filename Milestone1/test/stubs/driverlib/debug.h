@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// debug.h
+//
+// Empty host stand in for the TivaWare driver library header so
+// modules that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_DEBUG_H__
+#define __DRIVERLIB_DEBUG_H__
+
+#endif // __DRIVERLIB_DEBUG_H__
@@ -0,0 +1,22 @@
+// *******************************************************
+//
+// eeprom.h
+//
+// Host stand in for the TivaWare EEPROM header. The functions
+// are in eepromShim.c, which keeps the EEPROM in a file.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_EEPROM_H__
+#define __DRIVERLIB_EEPROM_H__
+
+#include <stdint.h>
+
+#define EEPROM_INIT_OK      0
+#define EEPROM_INIT_ERROR   2
+
+uint32_t EEPROMInit (void);
+void EEPROMRead (uint32_t *data, uint32_t address, uint32_t count);
+uint32_t EEPROMProgram (uint32_t *data, uint32_t address, uint32_t count);
+
+#endif // __DRIVERLIB_EEPROM_H__
@@ -0,0 +1,47 @@
+// *******************************************************
+//
+// gpio.h
+//
+// Host stand in for the TivaWare GPIO header so module
+// headers that name pins can be included by the host tests.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_GPIO_H__
+#define __DRIVERLIB_GPIO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GPIO_PIN_0      0x00000001
+#define GPIO_PIN_1      0x00000002
+#define GPIO_PIN_2      0x00000004
+#define GPIO_PIN_4      0x00000010
+#define GPIO_PIN_6      0x00000040
+#define GPIO_PIN_7      0x00000080
+#define GPIO_PORTA_BASE 0x40004000
+#define GPIO_PORTB_BASE 0x40005000
+#define GPIO_PORTC_BASE 0x40006000
+#define GPIO_PORTD_BASE 0x40007000
+#define GPIO_PORTE_BASE 0x40024000
+#define GPIO_PORTF_BASE 0x40025000
+
+#define GPIO_STRENGTH_2MA       0x00000001
+#define GPIO_STRENGTH_4MA       0x00000002
+#define GPIO_PIN_TYPE_STD_WPU   0x0000000A
+#define GPIO_PIN_TYPE_STD_WPD   0x0000000C
+#define GPIO_RISING_EDGE        0x00000004
+#define GPIO_BOTH_EDGES         0x00000001
+
+// Tests that use these define them, GPIOPinRead giving the simulated pins.
+int32_t GPIOPinRead (uint32_t port, uint8_t pins);
+void GPIOPinTypeGPIOInput (uint32_t port, uint8_t pins);
+void GPIOPadConfigSet (uint32_t port, uint8_t pins, uint32_t strength, uint32_t type);
+void GPIOIntTypeSet (uint32_t port, uint8_t pins, uint32_t type);
+void GPIOIntRegister (uint32_t port, void (*handler) (void));
+void GPIOIntEnable (uint32_t port, uint32_t flags);
+void GPIOIntDisable (uint32_t port, uint32_t flags);
+uint32_t GPIOIntStatus (uint32_t port, bool masked);
+void GPIOIntClear (uint32_t port, uint32_t flags);
+
+#endif // __DRIVERLIB_GPIO_H__
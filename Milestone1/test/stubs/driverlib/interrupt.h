@@ -0,0 +1,20 @@
+// *******************************************************
+//
+// interrupt.h
+//
+// Host stand in for the TivaWare interrupt header. Tests that
+// use it define the functions to track the simulated master
+// interrupt mask.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+#include <stdbool.h>
+
+// Both return true if interrupts were masked when called.
+bool IntMasterEnable (void);
+bool IntMasterDisable (void);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
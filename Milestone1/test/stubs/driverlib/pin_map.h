@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// pin_map.h
+//
+// Empty host stand in for the TivaWare driver library header so
+// module headers that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#endif // __DRIVERLIB_PIN_MAP_H__
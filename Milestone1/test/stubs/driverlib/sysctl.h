@@ -0,0 +1,29 @@
+// *******************************************************
+//
+// sysctl.h
+//
+// Host stand in for the TivaWare system control header. Tests
+// that use it define SysCtlClockGet to give the clock rate,
+// and the peripheral functions or link eepromShim.c.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_SYSCTL_H__
+#define __DRIVERLIB_SYSCTL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SYSCTL_PERIPH_EEPROM0   0xf0005800
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOB     0xf0000801
+#define SYSCTL_PERIPH_GPIOC     0xf0000802
+#define SYSCTL_PERIPH_GPIOD     0xf0000803
+#define SYSCTL_PERIPH_GPIOE     0xf0000804
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+
+uint32_t SysCtlClockGet (void);
+void SysCtlPeripheralEnable (uint32_t peripheral);
+bool SysCtlPeripheralReady (uint32_t peripheral);
+
+#endif // __DRIVERLIB_SYSCTL_H__
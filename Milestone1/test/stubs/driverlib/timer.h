@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// timer.h
+//
+// Empty host stand in for the TivaWare driver library header so
+// module headers that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __DRIVERLIB_TIMER_H__
+#define __DRIVERLIB_TIMER_H__
+
+#endif // __DRIVERLIB_TIMER_H__
@@ -0,0 +1,125 @@
+// *******************************************************
+//
+// eepromShim.c
+//
+// File backed stand in for the on-chip EEPROM, for host tests
+// of the settings store. Erased words read as all ones like
+// the real part, and a write can be made to stop part way to
+// act like a reset during programming.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "driverlib/eeprom.h"
+#include "driverlib/sysctl.h"
+#include "eepromShim.h"
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static FILE *eepromFile = NULL;
+static uint32_t tearWords = EEPROM_SHIM_NO_TEAR;
+
+//*****************************************************************************
+// eepromShimOpen - Uses the file at path as the EEPROM, erasing it first if
+// erase is true.
+//*****************************************************************************
+void
+eepromShimOpen (const char *path, bool erase)
+{
+    uint32_t i;
+
+    eepromShimClose ();
+    eepromFile = fopen (path, erase ? "w+b" : "r+b");
+    if (eepromFile == NULL)
+    {
+        perror (path);
+        exit (1);
+    }
+    if (erase)
+    {
+        for (i = 0; i < EEPROM_SHIM_BYTES; i++)
+        {
+            fputc (0xFF, eepromFile);
+        }
+    }
+    tearWords = EEPROM_SHIM_NO_TEAR;
+}
+
+//*****************************************************************************
+// eepromShimClose - Closes the EEPROM file.
+//*****************************************************************************
+void
+eepromShimClose (void)
+{
+    if (eepromFile != NULL)
+    {
+        fclose (eepromFile);
+        eepromFile = NULL;
+    }
+}
+
+//*****************************************************************************
+// eepromShimTearAfter - Makes later writes stop after words words and return
+// an error, or never with EEPROM_SHIM_NO_TEAR.
+//*****************************************************************************
+void
+eepromShimTearAfter (uint32_t words)
+{
+    tearWords = words;
+}
+
+//*****************************************************************************
+// TivaWare EEPROM and system control functions
+//*****************************************************************************
+void
+SysCtlPeripheralEnable (uint32_t peripheral)
+{
+}
+
+bool
+SysCtlPeripheralReady (uint32_t peripheral)
+{
+    return true;
+}
+
+uint32_t
+EEPROMInit (void)
+{
+    return (eepromFile != NULL) ? EEPROM_INIT_OK : EEPROM_INIT_ERROR;
+}
+
+void
+EEPROMRead (uint32_t *data, uint32_t address, uint32_t count)
+{
+    fseek (eepromFile, address, SEEK_SET);
+    if (fread (data, 1, count, eepromFile) != count)
+    {
+        fprintf (stderr, "EEPROMRead past end at %u\n", address);
+        exit (1);
+    }
+}
+
+uint32_t
+EEPROMProgram (uint32_t *data, uint32_t address, uint32_t count)
+{
+    uint32_t words = count / 4;
+
+    if (words > tearWords)
+    {
+        words = tearWords;
+    }
+    fseek (eepromFile, address, SEEK_SET);
+    fwrite (data, 4, words, eepromFile);
+    fflush (eepromFile);
+    return (words * 4 == count) ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#ifndef EEPROMSHIM_H_
+#define EEPROMSHIM_H_
+
+// *******************************************************
+//
+// eepromShim.h
+//
+// File backed stand in for the on-chip EEPROM, for host tests
+// of the settings store. Erased words read as all ones like
+// the real part, and a write can be made to stop part way to
+// act like a reset during programming.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define EEPROM_SHIM_BYTES   2048    // Size of the TM4C123 EEPROM
+#define EEPROM_SHIM_NO_TEAR UINT32_MAX
+
+//*****************************************************************************
+// eepromShimOpen - Uses the file at path as the EEPROM, erasing it first if
+// erase is true.
+//*****************************************************************************
+void
+eepromShimOpen (const char *path, bool erase);
+
+//*****************************************************************************
+// eepromShimClose - Closes the EEPROM file.
+//*****************************************************************************
+void
+eepromShimClose (void);
+
+//*****************************************************************************
+// eepromShimTearAfter - Makes later writes stop after words words and return
+// an error, or never with EEPROM_SHIM_NO_TEAR.
+//*****************************************************************************
+void
+eepromShimTearAfter (uint32_t words);
+
+#endif /* EEPROMSHIM_H_ */
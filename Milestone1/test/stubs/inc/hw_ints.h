@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// hw_ints.h
+//
+// Empty host stand in for the TivaWare interrupt numbers header
+// so modules that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __INC_HW_INTS_H__
+#define __INC_HW_INTS_H__
+
+#endif // __INC_HW_INTS_H__
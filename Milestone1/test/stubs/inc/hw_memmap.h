@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// hw_memmap.h
+//
+// Empty host stand in for the TivaWare register map header so
+// module headers that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __INC_HW_MEMMAP_H__
+#define __INC_HW_MEMMAP_H__
+
+#endif // __INC_HW_MEMMAP_H__
@@ -0,0 +1,13 @@
+// *******************************************************
+//
+// hw_types.h
+//
+// Empty host stand in for the TivaWare register types header so
+// modules that include it build in the host tests.
+//
+// *******************************************************
+
+#ifndef __INC_HW_TYPES_H__
+#define __INC_HW_TYPES_H__
+
+#endif // __INC_HW_TYPES_H__
@@ -0,0 +1,24 @@
+// *******************************************************
+//
+// tm4c123gh6pm.h
+//
+// Host stand in for the TM4C123 register header. Only the
+// port F unlock registers used by buttons4.c are given, as
+// plain variables the test defines.
+//
+// *******************************************************
+
+#ifndef __TM4C123GH6PM_H__
+#define __TM4C123GH6PM_H__
+
+#include <stdint.h>
+
+extern uint32_t stubPortFLock;
+extern uint32_t stubPortFCommit;
+
+#define GPIO_PORTF_LOCK_R   stubPortFLock
+#define GPIO_PORTF_CR_R     stubPortFCommit
+#define GPIO_LOCK_KEY       0x4C4F434B
+#define GPIO_LOCK_M         0xFFFFFFFF
+
+#endif // __TM4C123GH6PM_H__
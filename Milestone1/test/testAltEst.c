@@ -0,0 +1,216 @@
+// *******************************************************
+//
+// testAltEst.c
+//
+// Host tests for the Kalman filter altitude estimator. A
+// simulated heli with thrust, weight and drag is flown
+// through altitude steps, and the estimator is fed its
+// altitude with measurement noise and its main duty. The
+// altitude and velocity errors are checked to stay bounded
+// and the covariance to stay symmetric and positive.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "testUtils.h"
+#include "altEstimator.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define UPDATE_HZ       100         // Estimator updates per second
+#define PLANT_STEPS     10          // Plant steps per estimator update
+#define SIM_THRUST_GAIN 18.0f       // Heli climb acceleration in %/s^2 per %, off the model
+#define SIM_HOVER_PER   45.0f       // Main duty the heli hovers at, off the assumed
+#define SIM_DRAG        3.0f        // Drag deceleration in %/s^2 per %/s, not modelled
+#define SIM_DUTY_SD     2.0f        // Thrust noise as main duty SD in %
+#define MEAS_SD         0.5f        // Altitude measurement noise SD in %
+#define SETTLE_S        2           // Time allowed after a reset or step to converge
+#define ALT_ERR_MAX     (4 * MEAS_SD)
+#define VEL_ERR_MAX     8.0f
+#define PI              3.14159265f
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    float alt;          // %
+    float vel;          // %/s
+} plant_t;
+
+typedef struct {
+    float altErrMax;    // Largest errors once settled
+    float velErrMax;
+    float altErrSq;     // Sum of squared altitude errors once settled
+    uint32_t settled;   // Updates counted once settled
+    bool covOk;         // P symmetric and positive definite on every update
+} errors_t;
+
+//*****************************************************************************
+// gauss - Returns a normally distributed random number with SD sd.
+//*****************************************************************************
+static float
+gauss (float sd)
+{
+    float u1 = (rand () + 1.0f) / (RAND_MAX + 2.0f);
+    float u2 = (rand () + 1.0f) / (RAND_MAX + 2.0f);
+
+    return sd * sqrtf (-2 * logf (u1)) * cosf (2 * PI * u2);
+}
+
+//*****************************************************************************
+// covOk - Returns true if P is exactly symmetric and positive definite, by
+// its leading principal minors all being positive.
+//*****************************************************************************
+static bool
+covOk (const float P[EST_STATES][EST_STATES])
+{
+    uint8_t i, j;
+    double det2, det3;
+
+    for (i = 0; i < EST_STATES; i++)
+    {
+        for (j = 0; j < EST_STATES; j++)
+        {
+            if (P[i][j] != P[j][i] || !isfinite (P[i][j]))
+            {
+                return false;
+            }
+        }
+    }
+    det2 = (double) P[0][0] * P[1][1] - (double) P[0][1] * P[1][0];
+    det3 = P[0][0] * ((double) P[1][1] * P[2][2] - (double) P[1][2] * P[2][1]) -
+           P[0][1] * ((double) P[1][0] * P[2][2] - (double) P[1][2] * P[2][0]) +
+           P[0][2] * ((double) P[1][0] * P[2][1] - (double) P[1][1] * P[2][0]);
+    return P[0][0] > 0 && det2 > 0 && det3 > 0;
+}
+
+//*****************************************************************************
+// fly - Flies the heli to target for seconds with a PD controller on the
+// measured altitude, updating the estimate and its errors. Errors are only
+// counted after SETTLE_S.
+//*****************************************************************************
+static void
+fly (plant_t *heli, float target, uint32_t seconds, errors_t *err)
+{
+    const float dt = 1.0f / UPDATE_HZ;
+    uint32_t n;
+    uint8_t i;
+
+    for (n = 0; n < seconds * UPDATE_HZ; n++)
+    {
+        float meas = heli->alt + gauss (MEAS_SD);
+        float duty = SIM_HOVER_PER + 1.0f * (target - meas) - 0.5f * getAltVelocity ();
+
+        if (duty < 0)
+        {
+            duty = 0;
+        }
+        else if (duty > 100)
+        {
+            duty = 100;
+        }
+
+        // The heli moves on under the duty until the next update, with noise
+        // on its thrust, then the estimator sees where it got to.
+        float thrust = SIM_THRUST_GAIN * (duty - SIM_HOVER_PER + gauss (SIM_DUTY_SD));
+        for (i = 0; i < PLANT_STEPS; i++)
+        {
+            float acc = thrust - SIM_DRAG * heli->vel;
+            float h = dt / PLANT_STEPS;
+
+            heli->alt += heli->vel * h + 0.5f * acc * h * h;
+            heli->vel += acc * h;
+        }
+        updateAltEstimator (heli->alt + gauss (MEAS_SD), duty, dt);
+
+        if (!covOk (getAltEst ()->P))
+        {
+            err->covOk = false;
+        }
+        if (n >= SETTLE_S * UPDATE_HZ)
+        {
+            float altErr = fabsf (getAltEstimate () - heli->alt);
+            float velErr = fabsf (getAltVelocity () - heli->vel);
+
+            err->altErrMax = fmaxf (err->altErrMax, altErr);
+            err->velErrMax = fmaxf (err->velErrMax, velErr);
+            err->altErrSq += altErr * altErr;
+            err->settled++;
+        }
+    }
+}
+
+static void
+testTracking (void)
+{
+    plant_t heli = {10, 0};
+    errors_t err = {0, 0, 0, 0, true};
+    const float targets[] = {50, 80, 20, 60, 10};
+    uint8_t i;
+
+    srand (1);
+    setAltMeasNoise (MEAS_SD);
+    resetAltEstimator (heli.alt, ALT_EST_HOVER_PER);
+    CHECK(covOk (getAltEst ()->P));
+
+    // Steps up and down, each held long enough to settle. The thrust gain,
+    // hover duty and drag all differ from the model.
+    for (i = 0; i < sizeof(targets) / sizeof(targets[0]); i++)
+    {
+        fly (&heli, targets[i], 6, &err);
+        CHECK(fabsf (heli.alt - targets[i]) < 2);
+    }
+    printf ("altitude error max %.2f %% rms %.2f %%, velocity error max %.2f %%/s\n",
+            err.altErrMax, sqrtf (err.altErrSq / err.settled), err.velErrMax);
+    CHECK(err.covOk);
+    CHECK(err.altErrMax < ALT_ERR_MAX);
+    CHECK(err.velErrMax < VEL_ERR_MAX);
+
+    // Smoother than the measurements it is given.
+    CHECK(sqrtf (err.altErrSq / err.settled) < MEAS_SD);
+
+    // Hovering, the thrust offset gives the duty the heli really hovers at,
+    // though the thrust gain is off.
+    float thrustGain, accNoise;
+    getAltEstModel (&thrustGain, &accNoise);
+    CHECK(fabsf (-getAltEst ()->x[EST_BIAS] / thrustGain - SIM_HOVER_PER) < 1);
+}
+
+static void
+testCovariance (void)
+{
+    plant_t heli = {30, 0};
+    errors_t err = {0, 0, 0, 0, true};
+
+    // Long flight with the least measurement noise set, giving the largest
+    // gains, where rounding in the covariance update matters most.
+    srand (2);
+    setAltMeasNoise (0);
+    resetAltEstimator (heli.alt, SIM_HOVER_PER);
+    fly (&heli, 30, 600, &err);
+    CHECK(err.covOk);
+
+    // The uncertainty settles, the altitude SD within the measurement SD.
+    const altEst_t *est = getAltEst ();
+    CHECK(est->P[EST_ALT][EST_ALT] > 0);
+    CHECK(sqrtf (est->P[EST_ALT][EST_ALT]) <= ALT_EST_MIN_MEAS_SD);
+    setAltMeasNoise (MEAS_SD);
+}
+
+int
+main (void)
+{
+    testTracking ();
+    testCovariance ();
+    return TEST_DONE();
+}
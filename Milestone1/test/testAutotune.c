@@ -0,0 +1,208 @@
+// *******************************************************
+//
+// testAutotune.c
+//
+// Host tests for the relay feedback autotuner. The relay is
+// closed around a first order plus dead time model and the
+// ultimate gain and period found are compared with the exact
+// values for the model.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "testUtils.h"
+#include "autotune.h"
+#include "heliTimer.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define SIM_CLOCK_HZ    20000000    // Clock rate given by the fake SysCtlClockGet
+#define SIM_MAX_DELAY   100         // Longest plant dead time in updates
+#define HOVER_DUTY      DUTY_PER2Q16(40)
+#define PI              3.14159265
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    float gain;             // Output change per % duty at steady state
+    float tau;              // Time constant in s
+    float delay;            // Dead time in s
+} fopdt_t;
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static uint32_t simTicks;   // Fake down counting timer
+
+//*****************************************************************************
+// Fakes for the hardware used by autotune.c
+//*****************************************************************************
+uint32_t
+SysCtlClockGet (void)
+{
+    return SIM_CLOCK_HZ;
+}
+
+uint32_t
+timerGet (void)
+{
+    return simTicks;
+}
+
+//*****************************************************************************
+// ultimatePoint - Finds the exact ultimate gain and period of plant, where its
+// phase lag is 180 deg.
+//*****************************************************************************
+static void
+ultimatePoint (const fopdt_t *plant, double *Ku, double *Pu)
+{
+    double lo = 0, hi = PI / plant->delay;
+    uint8_t i;
+
+    // Phase lag atan(w tau) + w L rises with w, bisect for pi.
+    for (i = 0; i < 60; i++)
+    {
+        double w = (lo + hi) / 2;
+        if (atan (w * plant->tau) + w * plant->delay < PI)
+        {
+            lo = w;
+        } else {
+            hi = w;
+        }
+    }
+    *Ku = sqrt (1 + lo * plant->tau * lo * plant->tau) / plant->gain;
+    *Pu = 2 * PI / lo;
+}
+
+//*****************************************************************************
+// runRelay - Runs the relay test on axis against plant held at setpoint until
+// it ends or maxUpdates pass. Returns the final status.
+//*****************************************************************************
+static enum tuneStatus
+runRelay (enum pidAxis axis, const fopdt_t *plant, uint32_t maxUpdates)
+{
+    float delayed[SIM_MAX_DELAY] = {0};
+    uint16_t delayUpdates = (uint16_t) (plant->delay * CONTROLLER_RATE);
+    float out = 0;
+    uint32_t duty = HOVER_DUTY;
+    enum tuneStatus status = TUNE_RUNNING;
+    uint32_t n;
+
+    simTicks = 0;
+    startAutotune (axis, HOVER_DUTY);
+
+    for (n = 0; n < maxUpdates && status == TUNE_RUNNING; n++)
+    {
+        // Error is setpoint 0 minus the output, scaled like the controllers.
+        status = updateAutotune ((int32_t) (-out * DUTYSCALER), &duty);
+
+        // The plant sees the duty change from hover after the dead time.
+        float input = delayed[n % delayUpdates];
+        delayed[n % delayUpdates] = ((float) duty - HOVER_DUTY) * 100 / DUTY_Q16_ONE;
+        out += (plant->gain * input - out) * CONTROLLER_DT / plant->tau;
+        simTicks -= SIM_CLOCK_HZ / CONTROLLER_RATE;
+    }
+    return status;
+}
+
+static void
+testUltimatePoint (void)
+{
+    const fopdt_t plants[] = {
+        {20.0f, 1.0f, 0.2f},
+        {40.0f, 2.0f, 0.1f},
+        {8.0f, 1.0f, 0.5f},
+        {5.0f, 0.5f, 0.5f},
+        {4.0f, 0.2f, 0.4f},
+    };
+    const tuneResult_t *result = getAutotuneResult ();
+    double Ku, Pu;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(plants) / sizeof(plants[0]); i++)
+    {
+        CHECK(runRelay (AXIS_ALT, &plants[i], 100000) == TUNE_DONE);
+        CHECK(result->cycles == AUTOTUNE_SKIP_CYCLES + AUTOTUNE_CYCLES);
+
+        // The describing function only sees the first harmonic. For lag
+        // dominant plants the output is nearer a triangle than a sine, so
+        // Ku comes out low, giving cautious gains. The period is closer.
+        ultimatePoint (&plants[i], &Ku, &Pu);
+        CHECK(result->Ku > 0.65 * Ku && result->Ku < 1.05 * Ku);
+        CHECK(fabs (result->Pu - Pu) < 0.2 * Pu);
+    }
+}
+
+static void
+testGains (void)
+{
+    const fopdt_t plant = {20.0f, 1.0f, 0.2f};
+    const tuneResult_t *result = getAutotuneResult ();
+
+    // Ziegler-Nichols PID from the ultimate point found.
+    setAutotuneRule (TUNE_ZIEGLER_NICHOLS);
+    CHECK(runRelay (AXIS_ALT, &plant, 100000) == TUNE_DONE);
+    float Kp = 0.6f * result->Ku;
+    CHECK(fabsf (result->gains.Kp - Kp) < 1e-4f * Kp);
+    CHECK(fabsf (result->gains.Ki - Kp / (result->Pu / 2) * DUTYSCALER / CONTROLLER_RATE) <
+          1e-3f * result->gains.Ki);
+    CHECK(fabsf (result->gains.Kd - Kp * result->Pu / 8 * CONTROLLER_RATE) <
+          1e-3f * result->gains.Kd);
+
+    // Tyreus-Luyben is less aggressive.
+    setAutotuneRule (TUNE_TYREUS_LUYBEN);
+    CHECK(runRelay (AXIS_ALT, &plant, 100000) == TUNE_DONE);
+    CHECK(result->gains.Kp < Kp);
+    setAutotuneRule (AUTOTUNE_RULE);
+}
+
+static void
+testAborts (void)
+{
+    // A plant that barely responds never crosses the hysteresis and times out.
+    const fopdt_t dead = {0.001f, 1.0f, 0.1f};
+    CHECK(runRelay (AXIS_ALT, &dead, (AUTOTUNE_TIMEOUT_MS + 1000) * CONTROLLER_RATE / 1000) ==
+          TUNE_FAILED);
+
+    // A plant with a long dead time swings past the error limit.
+    const fopdt_t slow = {50.0f, 0.5f, 0.9f};
+    CHECK(runRelay (AXIS_YAW, &slow, 100000) == TUNE_FAILED);
+
+    // Stopping a running test fails it, and the relay returns to hover.
+    const fopdt_t plant = {20.0f, 1.0f, 0.2f};
+    uint32_t duty;
+    CHECK(runRelay (AXIS_ALT, &plant, 10) == TUNE_RUNNING);
+    stopAutotune ();
+    CHECK(getAutotuneResult ()->status == TUNE_FAILED);
+    CHECK(updateAutotune (0, &duty) == TUNE_FAILED);
+    CHECK(duty == HOVER_DUTY);
+}
+
+static void
+testArm (void)
+{
+    armAutotune (true);
+    CHECK(autotuneArmed ());
+    startAutotune (AXIS_YAW, HOVER_DUTY);
+    CHECK(!autotuneArmed ());
+}
+
+int
+main (void)
+{
+    testUltimatePoint ();
+    testGains ();
+    testAborts ();
+    testArm ();
+    return TEST_DONE();
+}
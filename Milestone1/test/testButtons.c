@@ -0,0 +1,331 @@
+// *******************************************************
+//
+// testButtons.c
+//
+// Host tests for the button debouncer and event queue. The
+// pins are simulated and polled through updateButtons, and
+// the time per poll is compared with the per button loop it
+// replaced.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "testUtils.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "inc/tm4c123gh6pm.h"
+#include "buttons4.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define TIMING_POLLS    2000000     // Polls timed for each case
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static bool pushedNow[NUM_BUTS];    // Simulated buttons held down
+static bool intMasked;              // Simulated master interrupt mask
+
+// Pins of each button, giving the level read while pushed and released.
+static const struct {
+    uint32_t port;
+    uint8_t pin;
+    bool normal;
+} butPins[NUM_BUTS] = {
+    {UP_BUT_PORT_BASE,      UP_BUT_PIN,     UP_BUT_NORMAL},
+    {DOWN_BUT_PORT_BASE,    DOWN_BUT_PIN,   DOWN_BUT_NORMAL},
+    {LEFT_BUT_PORT_BASE,    LEFT_BUT_PIN,   LEFT_BUT_NORMAL},
+    {RIGHT_BUT_PORT_BASE,   RIGHT_BUT_PIN,  RIGHT_BUT_NORMAL},
+    {SW_PORT_BASE,          SW_PIN,         SW_BUT_NORMAL},
+    {RESET_PORT_BASE,       RESET_PIN,      RESET_BUT_NORMAL},
+};
+
+uint32_t stubPortFLock;
+uint32_t stubPortFCommit;
+
+//*****************************************************************************
+// Fakes for the hardware used by buttons4.c
+//*****************************************************************************
+int32_t
+GPIOPinRead (uint32_t port, uint8_t pins)
+{
+    int32_t levels = 0;
+    uint8_t i;
+
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        if (butPins[i].port == port && (butPins[i].normal != pushedNow[i]))
+        {
+            levels |= butPins[i].pin;
+        }
+    }
+    return levels & pins;
+}
+
+void
+GPIOPinTypeGPIOInput (uint32_t port, uint8_t pins)
+{
+}
+
+void
+GPIOPadConfigSet (uint32_t port, uint8_t pins, uint32_t strength, uint32_t type)
+{
+}
+
+void
+SysCtlPeripheralEnable (uint32_t peripheral)
+{
+}
+
+bool
+IntMasterDisable (void)
+{
+    bool was = intMasked;
+    intMasked = true;
+    return was;
+}
+
+bool
+IntMasterEnable (void)
+{
+    bool was = intMasked;
+    intMasked = false;
+    return was;
+}
+
+//*****************************************************************************
+// start - Initialises the buttons with none pushed.
+//*****************************************************************************
+static void
+start (void)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        pushedNow[i] = false;
+    }
+    initButtons ();
+    setButtonRepeat (BUT_LONG_PRESS_POLLS, BUT_REPEAT_POLLS);
+}
+
+//*****************************************************************************
+// poll - Polls n times, returning the OR of the edges found.
+//*****************************************************************************
+static uint32_t
+poll (uint32_t n)
+{
+    uint32_t edges = 0;
+
+    while (n--)
+    {
+        edges |= updateButtons ();
+    }
+    return edges;
+}
+
+//*****************************************************************************
+// Per button debounce that the vertical counters replaced, kept to compare
+// the time per poll against.
+//*****************************************************************************
+static bool oldState[NUM_BUTS];
+static uint8_t oldCount[NUM_BUTS];
+static bool oldFlag[NUM_BUTS];
+
+static void
+oldUpdateButtons (void)
+{
+    bool value[NUM_BUTS];
+    int i;
+
+    value[UP] = (GPIOPinRead (UP_BUT_PORT_BASE, UP_BUT_PIN) == UP_BUT_PIN);
+    value[DOWN] = (GPIOPinRead (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN) == DOWN_BUT_PIN);
+    value[LEFT] = (GPIOPinRead (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN) == LEFT_BUT_PIN);
+    value[RIGHT] = (GPIOPinRead (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN) == RIGHT_BUT_PIN);
+    value[SW] = (GPIOPinRead (SW_PORT_BASE, SW_PIN) == SW_PIN);
+    value[RESET] = (GPIOPinRead (RESET_PORT_BASE, RESET_PIN) == RESET_PIN);
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        if (value[i] != oldState[i])
+        {
+            oldCount[i]++;
+            if (oldCount[i] >= NUM_BUT_POLLS)
+            {
+                oldState[i] = value[i];
+                oldFlag[i] = true;
+                oldCount[i] = 0;
+            }
+        }
+        else
+            oldCount[i] = 0;
+    }
+}
+
+static void
+testDebounce (void)
+{
+    uint8_t i;
+
+    start ();
+    CHECK(poll (10) == 0);
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        CHECK(checkButton (i) == NO_CHANGE);
+    }
+
+    // Each button, active high or low, changes after NUM_BUT_POLLS polls.
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        pushedNow[i] = true;
+        CHECK(poll (NUM_BUT_POLLS - 1) == 0);
+        CHECK(checkButton (i) == NO_CHANGE);
+        CHECK(updateButtons () == BUT_BIT(i));
+        CHECK(checkButton (i) == PUSHED);
+        CHECK(checkButton (i) == NO_CHANGE);
+
+        pushedNow[i] = false;
+        CHECK(poll (NUM_BUT_POLLS - 1) == 0);
+        CHECK(updateButtons () == BUT_BIT(i) << 16);
+        CHECK(checkButton (i) == RELEASED);
+    }
+
+    // Bouncing shorter than NUM_BUT_POLLS never changes the state.
+    for (i = 0; i < 50; i++)
+    {
+        pushedNow[UP] = (i % NUM_BUT_POLLS) != 0;
+        CHECK(updateButtons () == 0);
+    }
+    CHECK(checkButton (UP) == NO_CHANGE);
+}
+
+static void
+testEvents (void)
+{
+    butEvent_t event;
+    uint32_t n;
+
+    // A push and release each give a timestamped event.
+    start ();
+    pushedNow[DOWN] = true;
+    poll (NUM_BUT_POLLS);
+    CHECK(getButtonEvent (&event));
+    CHECK(event.butName == DOWN && event.type == BUT_PUSHED && event.time == NUM_BUT_POLLS);
+    pushedNow[DOWN] = false;
+    poll (NUM_BUT_POLLS);
+    CHECK(getButtonEvent (&event));
+    CHECK(event.butName == DOWN && event.type == BUT_RELEASED && event.time == 2 * NUM_BUT_POLLS);
+    CHECK(!getButtonEvent (&event));
+
+    // SW and RESET give no events.
+    pushedNow[SW] = true;
+    pushedNow[RESET] = true;
+    poll (NUM_BUT_POLLS);
+    CHECK(!getButtonEvent (&event));
+
+    // Holding gives a long press then repeats.
+    start ();
+    pushedNow[LEFT] = true;
+    poll (NUM_BUT_POLLS);
+    CHECK(getButtonEvent (&event) && event.type == BUT_PUSHED);
+    poll (BUT_LONG_PRESS_POLLS);
+    CHECK(getButtonEvent (&event) && event.type == BUT_LONG_PRESS);
+    CHECK(event.time == NUM_BUT_POLLS + BUT_LONG_PRESS_POLLS);
+    CHECK(!getButtonEvent (&event));
+    for (n = 1; n <= 3; n++)
+    {
+        poll (BUT_REPEAT_POLLS);
+        CHECK(getButtonEvent (&event) && event.type == BUT_REPEAT);
+        CHECK(event.time == NUM_BUT_POLLS + BUT_LONG_PRESS_POLLS + n * BUT_REPEAT_POLLS);
+    }
+
+    // Events past a full queue are counted as dropped, the oldest are kept.
+    start ();
+    setButtonRepeat (1, 1);
+    pushedNow[RIGHT] = true;
+    poll (NUM_BUT_POLLS + BUT_EVENT_QUEUE_SIZE + 9);
+    CHECK(getButtonEventsDropped () == 10);
+    CHECK(getButtonEvent (&event) && event.type == BUT_PUSHED);
+    for (n = 1; n < BUT_EVENT_QUEUE_SIZE; n++)
+    {
+        CHECK(getButtonEvent (&event));
+    }
+    CHECK(!getButtonEvent (&event));
+}
+
+static void
+testCheckMasked (void)
+{
+    // Called with interrupts on, they are back on after.
+    start ();
+    pushedNow[UP] = true;
+    poll (NUM_BUT_POLLS);
+    intMasked = false;
+    CHECK(checkButton (UP) == PUSHED);
+    CHECK(!intMasked);
+
+    // Called from an ISR or a critical section, they stay off.
+    pushedNow[UP] = false;
+    poll (NUM_BUT_POLLS);
+    intMasked = true;
+    CHECK(checkButton (UP) == RELEASED);
+    CHECK(intMasked);
+    intMasked = false;
+}
+
+//*****************************************************************************
+// nsPerPoll - Returns the host time per call of update over TIMING_POLLS.
+//*****************************************************************************
+static double
+nsPerPoll (void (*update) (void))
+{
+    clock_t start = clock ();
+    uint32_t n;
+
+    for (n = 0; n < TIMING_POLLS; n++)
+    {
+        update ();
+    }
+    return (double) (clock () - start) / CLOCKS_PER_SEC * 1e9 / TIMING_POLLS;
+}
+
+static void
+newUpdateButtons (void)
+{
+    updateButtons ();
+}
+
+static void
+testTiming (void)
+{
+    double newIdle, newHeld, oldIdle, oldHeld;
+
+    // Host times only show the relative cost, with the same fake GPIO reads,
+    // so they are printed rather than checked.
+    start ();
+    newIdle = nsPerPoll (newUpdateButtons);
+    oldIdle = nsPerPoll (oldUpdateButtons);
+    pushedNow[UP] = pushedNow[DOWN] = pushedNow[LEFT] = pushedNow[RIGHT] = true;
+    newHeld = nsPerPoll (newUpdateButtons);
+    oldHeld = nsPerPoll (oldUpdateButtons);
+    printf ("updateButtons: %.1f ns idle, %.1f ns 4 held; per button loop: %.1f ns, %.1f ns\n",
+            newIdle, newHeld, oldIdle, oldHeld);
+}
+
+int
+main (void)
+{
+    testDebounce ();
+    testEvents ();
+    testCheckMasked ();
+    testTiming ();
+    return TEST_DONE();
+}
@@ -0,0 +1,328 @@
+// *******************************************************
+//
+// testFilter.c
+//
+// Host tests for the altitude filter pipeline. The biquad
+// designs are checked for unity DC gain, step response,
+// noise gain and coefficient range down to the lowest
+// cutoff. The spike rejection median is checked against a
+// sort for every ordering of window values, and spikes are
+// checked to be replaced while steps pass through.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "testUtils.h"
+#include "filter.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define MEDIAN_LEVELS   5       // Distinct values tried in each window place
+#define MEDIAN_STEP     10      // Spacing of those values, past the threshold
+#define LEVEL           2000    // Quiet altitude reading in ADC counts
+#define THRESHOLD       60      // Spike threshold in ADC counts
+#define SAMPLE_HZ       1000    // Altitude sample rate
+#define STEP            4000    // Step input in ADC counts
+#define SETTLE_CYCLES   5       // Cutoff periods allowed for a step to settle
+#define SETTLE_TOL      (STEP / 100)
+#define PI              3.14159265f
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    float cutoffHz;
+    uint8_t order;
+    float overshoot;    // Largest step overshoot as a fraction of the step, a
+                        // little over the Butterworth 4.3 % and 14.3 %
+} design_t;
+
+// The altitude default, the supply and current default, the highest order
+// and the lowest cutoff at the highest order.
+static const design_t designs[] = {
+    {25,                            2, 0.045f},
+    {5,                             2, 0.045f},
+    {25,                            6, 0.145f},
+    {FILTER_MIN_CUTOFF * SAMPLE_HZ, 6, 0.145f},
+};
+#define NUM_DESIGNS     (sizeof(designs) / sizeof(designs[0]))
+
+//*****************************************************************************
+// compareInt - Orders int32_t values for qsort.
+//*****************************************************************************
+static int
+compareInt (const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *) a;
+    int32_t y = *(const int32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+//*****************************************************************************
+// fill - Empties spike and fills its window with level.
+//*****************************************************************************
+static void
+fill (spikeFilter_t *spike, int32_t threshold, int32_t level)
+{
+    uint8_t i;
+
+    initSpikeFilter (spike, threshold);
+    for (i = 0; i < SPIKE_WINDOW; i++)
+    {
+        rejectSpikes (spike, level);
+    }
+}
+
+static void
+testCoefs (void)
+{
+    filter_t filter, lower;
+    uint8_t d, i;
+
+    for (d = 0; d < NUM_DESIGNS; d++)
+    {
+        initLowPass (&filter, designs[d].cutoffHz, SAMPLE_HZ, designs[d].order, 1);
+        CHECK(filter.numStages == designs[d].order / 2);
+
+        // Each section has exactly unity DC gain, b0 + b1 + b2 = 1 - a1 - a2
+        // with the a terms stored negated, and its poles inside the unit
+        // circle, which is a1 within (0, 2) and a2 within (-1, 0) in Q30 for
+        // a low pass. A wrapped a1 would come out negative.
+        for (i = 0; i < filter.numStages; i++)
+        {
+            const biquad_t *bq = &filter.stage[i];
+            int64_t one = 1LL << FILTER_COEF_SHIFT;
+
+            CHECK(bq->b0 > 0 && bq->b1 == 2 * bq->b0 && bq->b2 == bq->b0);
+            CHECK((int64_t) bq->b0 + bq->b1 + bq->b2 == one - bq->a1 - bq->a2);
+            CHECK(bq->a1 > 0 && bq->a2 < 0 && bq->a2 > -one);
+            CHECK(one - bq->a1 - bq->a2 > 0);
+        }
+    }
+
+    // Cutoffs below the lowest are designed at the lowest.
+    initLowPass (&filter, FILTER_MIN_CUTOFF * SAMPLE_HZ, SAMPLE_HZ, 6, 1);
+    initLowPass (&lower, 0, SAMPLE_HZ, 6, 1);
+    for (i = 0; i < filter.numStages; i++)
+    {
+        CHECK(lower.stage[i].b0 == filter.stage[i].b0);
+        CHECK(lower.stage[i].a1 == filter.stage[i].a1);
+        CHECK(lower.stage[i].a2 == filter.stage[i].a2);
+    }
+
+    // Orders are rounded up to even and limited to the stages there are.
+    initLowPass (&filter, 25, SAMPLE_HZ, 3, 1);
+    CHECK(filter.numStages == 2);
+    initLowPass (&filter, 25, SAMPLE_HZ, 2 * FILTER_MAX_STAGES + 2, 1);
+    CHECK(filter.numStages == FILTER_MAX_STAGES);
+}
+
+static void
+testStep (void)
+{
+    filter_t filter;
+    uint32_t n, settleSamples, settled;
+    int32_t out, peak;
+    uint8_t d;
+
+    for (d = 0; d < NUM_DESIGNS; d++)
+    {
+        initLowPass (&filter, designs[d].cutoffHz, SAMPLE_HZ, designs[d].order, 1);
+        settleSamples = SETTLE_CYCLES * SAMPLE_HZ / designs[d].cutoffHz;
+
+        // From rest at 0, step to STEP and run for twice the settle time.
+        resetFilter (&filter, 0);
+        peak = 0;
+        settled = 0;
+        for (n = 1; n <= 2 * settleSamples; n++)
+        {
+            filterSample (&filter, STEP);
+            out = getFilterOut (&filter);
+            if (out > peak)
+            {
+                peak = out;
+            }
+            if (abs (out - STEP) > SETTLE_TOL)
+            {
+                settled = n;
+            }
+        }
+
+        // Within 1 % in SETTLE_CYCLES cutoff periods, overshooting no more
+        // than a Butterworth does, and ending on the input.
+        CHECK(settled < settleSamples);
+        CHECK(peak > STEP);
+        CHECK(peak - STEP <= designs[d].overshoot * STEP + 1);
+        CHECK(out == STEP);
+    }
+
+    // The first sample sets the state, so a filter starts settled.
+    initLowPass (&filter, 25, SAMPLE_HZ, 6, 1);
+    filterSample (&filter, STEP);
+    CHECK(getFilterOut (&filter) == STEP);
+
+    // Decimated, an output is ready every decimate samples.
+    initLowPass (&filter, 25, SAMPLE_HZ, 2, 10);
+    for (n = 1; n <= 30; n++)
+    {
+        CHECK(filterSample (&filter, STEP) == (n % 10 == 0));
+    }
+}
+
+static void
+testNoiseGain (void)
+{
+    filter_t filter;
+    uint8_t d;
+
+    // For a Butterworth low pass of order n well below the Nyquist rate, the
+    // noise bandwidth is fc pi / (2n sin(pi / 2n)), and white noise is spread
+    // evenly to SAMPLE_HZ / 2.
+    for (d = 0; d < NUM_DESIGNS; d++)
+    {
+        float n = designs[d].order;
+        float fc = designs[d].cutoffHz;
+        float bandwidth = fc * PI / (2 * n * sinf (PI / (2 * n)));
+        float expected = sqrtf (bandwidth / (SAMPLE_HZ / 2));
+
+        initLowPass (&filter, fc, SAMPLE_HZ, designs[d].order, 1);
+        CHECK(fabsf (filterNoiseGain (&filter) - expected) < 0.01f * expected);
+    }
+}
+
+static void
+testMedian (void)
+{
+    spikeFilter_t spike;
+    int32_t window[SPIKE_WINDOW], sorted[SPIKE_WINDOW];
+    uint32_t n, code, wrong = 0, rejectsWrong = 0;
+    uint8_t i;
+
+    // Every window of MEDIAN_LEVELS values in each place, 3125 in all. With
+    // values further apart than the threshold, the last sample comes out as
+    // the median whether or not it is replaced, so the output is the median.
+    for (n = 0; n < 3125; n++)
+    {
+        code = n;
+        for (i = 0; i < SPIKE_WINDOW; i++)
+        {
+            window[i] = (code % MEDIAN_LEVELS) * MEDIAN_STEP;
+            sorted[i] = window[i];
+            code /= MEDIAN_LEVELS;
+        }
+        qsort (sorted, SPIKE_WINDOW, sizeof(sorted[0]), compareInt);
+
+        initSpikeFilter (&spike, 1);
+        int32_t out = 0;
+        for (i = 0; i < SPIKE_WINDOW; i++)
+        {
+            out = rejectSpikes (&spike, window[i]);
+        }
+        if (out != sorted[SPIKE_WINDOW / 2])
+        {
+            wrong++;
+        }
+        if (spike.rejects != (window[SPIKE_WINDOW - 1] != sorted[SPIKE_WINDOW / 2]))
+        {
+            rejectsWrong++;
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(rejectsWrong == 0);
+}
+
+static void
+testSpikes (void)
+{
+    spikeFilter_t spike;
+    uint8_t i;
+
+    // Samples pass through until the window is full.
+    initSpikeFilter (&spike, THRESHOLD);
+    CHECK(rejectSpikes (&spike, LEVEL) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + 1000) == LEVEL + 1000);
+    for (i = 0; i < SPIKE_WINDOW - 3; i++)
+    {
+        CHECK(rejectSpikes (&spike, LEVEL) == LEVEL);
+    }
+    CHECK(spike.rejects == 0);
+    CHECK(rejectSpikes (&spike, LEVEL + 1000) == LEVEL);
+    CHECK(spike.rejects == 1);
+
+    // Single spikes each way are replaced by the median.
+    fill (&spike, THRESHOLD, LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + 500) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL - 500) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL) == LEVEL);
+    CHECK(spike.rejects == 2);
+
+    // Two spikes in a row are both replaced.
+    fill (&spike, THRESHOLD, LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + 500) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + 450) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL) == LEVEL);
+    CHECK(spike.rejects == 2);
+
+    // Noise within the threshold of the median passes straight through.
+    fill (&spike, THRESHOLD, LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + THRESHOLD) == LEVEL + THRESHOLD);
+    CHECK(rejectSpikes (&spike, LEVEL - THRESHOLD) == LEVEL - THRESHOLD);
+    CHECK(rejectSpikes (&spike, LEVEL + THRESHOLD / 2) == LEVEL + THRESHOLD / 2);
+    CHECK(spike.rejects == 0);
+}
+
+static void
+testSteps (void)
+{
+    spikeFilter_t spike;
+    uint8_t i;
+
+    // A large step is held for two samples, as a spike would be, then the
+    // median moves and it passes through from the third.
+    fill (&spike, THRESHOLD, LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL - 800) == LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL - 800) == LEVEL);
+    for (i = 0; i < 10; i++)
+    {
+        CHECK(rejectSpikes (&spike, LEVEL - 800) == LEVEL - 800);
+    }
+    CHECK(spike.rejects == 2);
+
+    // A ramp within the threshold per median is followed without delay.
+    fill (&spike, THRESHOLD, LEVEL);
+    for (i = 1; i <= 50; i++)
+    {
+        CHECK(rejectSpikes (&spike, LEVEL + 20 * i) == LEVEL + 20 * i);
+    }
+    CHECK(spike.rejects == 0);
+
+    // Off passes every sample.
+    fill (&spike, 0, LEVEL);
+    CHECK(rejectSpikes (&spike, LEVEL + 3000) == LEVEL + 3000);
+    CHECK(rejectSpikes (&spike, 0) == 0);
+    CHECK(spike.rejects == 0);
+}
+
+int
+main (void)
+{
+    testCoefs ();
+    testStep ();
+    testNoiseGain ();
+    testMedian ();
+    testSpikes ();
+    testSteps ();
+    return TEST_DONE();
+}
@@ -0,0 +1,197 @@
+// *******************************************************
+//
+// testHealth.c
+//
+// Host tests for the sensor health monitor. Faults are
+// injected into simulated sensor inputs and checked to be
+// raised once, at the right time, and cleared when the
+// sensor recovers.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "testUtils.h"
+#include "heliHealth.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define SIM_ADC_RATE    1000    // Altitude samples per second from a working ADC
+#define SIM_ADC_LEVEL   3000    // Landed altitude reading in ADC counts
+#define MS2UPDATES(T)   ((T) * HEALTH_UPDATE_RATE / 1000)
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static healthInput_t in;
+
+//*****************************************************************************
+// step - Moves the inputs on one update with the ADC converting at adcRate and
+// noisy if noisy, and the yaw encoder stepping edgesPer steps, then runs the
+// checks. Returns the faults present.
+//*****************************************************************************
+static uint32_t
+step (uint32_t adcRate, bool noisy, uint32_t edgesPer)
+{
+    in.adcSamples += adcRate / HEALTH_UPDATE_RATE;
+    in.adcRaw = noisy ? SIM_ADC_LEVEL + rand () % 5 - 2 : SIM_ADC_LEVEL;
+    in.yawEdges += edgesPer;
+    return updateHealth (&in);
+}
+
+//*****************************************************************************
+// run - Steps n updates, returning the update the faults in mask were first
+// all present, or -1 if they never were.
+//*****************************************************************************
+static int32_t
+run (uint32_t n, uint32_t adcRate, bool noisy, uint32_t edgesPer, uint32_t mask)
+{
+    int32_t first = -1;
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        if ((step (adcRate, noisy, edgesPer) & mask) == mask && first < 0)
+        {
+            first = i;
+        }
+    }
+    return first;
+}
+
+//*****************************************************************************
+// start - Resets the monitor and inputs to a working, still heli.
+//*****************************************************************************
+static void
+start (void)
+{
+    resetHealth ();
+    in.adcSamples = 0;
+    in.adcRaw = SIM_ADC_LEVEL;
+    in.yawEdges = 0;
+    in.rotating = false;
+    in.findingRef = false;
+    srand (1);
+}
+
+static void
+testHealthy (void)
+{
+    start ();
+    CHECK(run (10 * HEALTH_ADC_WINDOW, SIM_ADC_RATE, true, 0, ~0u) < 0);
+    CHECK(getHealthFaults () == 0);
+
+    // Rotating with steps, then finding the reference in time.
+    in.rotating = true;
+    in.findingRef = true;
+    CHECK(run (MS2UPDATES(HEALTH_REF_MS) / 2, SIM_ADC_RATE, true, 1, ~0u) < 0);
+    in.findingRef = false;
+    CHECK(run (MS2UPDATES(HEALTH_REF_MS), SIM_ADC_RATE, true, 1, ~0u) < 0);
+}
+
+static void
+testAdcStuck (void)
+{
+    start ();
+    run (HEALTH_ADC_WINDOW, SIM_ADC_RATE, true, 0, 0);
+
+    // A frozen sample is found at the end of the next window.
+    CHECK(run (2 * HEALTH_ADC_WINDOW, SIM_ADC_RATE, false, 0,
+               HEALTH_FAULT_BIT(HEALTH_ADC_STUCK)) == HEALTH_ADC_WINDOW - 1);
+    CHECK(getHealthCount (HEALTH_ADC_STUCK) == 1);
+    CHECK(!(getHealthFaults () & HEALTH_FAULT_BIT(HEALTH_ADC_RATE)));
+
+    // Clears once noise returns, and is counted again on the next freeze.
+    run (HEALTH_ADC_WINDOW, SIM_ADC_RATE, true, 0, 0);
+    CHECK(!(getHealthFaults () & HEALTH_ADC_FAULTS));
+    run (HEALTH_ADC_WINDOW, SIM_ADC_RATE, false, 0, 0);
+    CHECK(getHealthCount (HEALTH_ADC_STUCK) == 2);
+}
+
+static void
+testAdcRate (void)
+{
+    start ();
+
+    // Converting at half the least rate.
+    CHECK(run (2 * HEALTH_ADC_WINDOW, HEALTH_ADC_MIN_RATE / 2, true, 0,
+               HEALTH_FAULT_BIT(HEALTH_ADC_RATE)) == HEALTH_ADC_WINDOW - 1);
+    CHECK(!(getHealthFaults () & HEALTH_FAULT_BIT(HEALTH_ADC_STUCK)));
+    CHECK(getHealthCount (HEALTH_ADC_RATE) == 1);
+
+    // Converting not at all is both stuck and slow.
+    start ();
+    CHECK(run (2 * HEALTH_ADC_WINDOW, 0, false, 0, HEALTH_ADC_FAULTS) == HEALTH_ADC_WINDOW - 1);
+
+    // Just over the least rate is fine.
+    start ();
+    CHECK(run (4 * HEALTH_ADC_WINDOW, HEALTH_ADC_MIN_RATE + HEALTH_UPDATE_RATE, true, 0,
+               HEALTH_FAULT_BIT(HEALTH_ADC_RATE)) < 0);
+}
+
+static void
+testYawEdges (void)
+{
+    start ();
+
+    // No steps while still is fine.
+    CHECK(run (2 * MS2UPDATES(HEALTH_YAW_EDGE_MS), SIM_ADC_RATE, true, 0,
+               HEALTH_FAULT_BIT(HEALTH_YAW_EDGES)) < 0);
+
+    // No steps while rotating is a fault after HEALTH_YAW_EDGE_MS.
+    in.rotating = true;
+    CHECK(run (2 * MS2UPDATES(HEALTH_YAW_EDGE_MS), SIM_ADC_RATE, true, 0,
+               HEALTH_FAULT_BIT(HEALTH_YAW_EDGES)) == MS2UPDATES(HEALTH_YAW_EDGE_MS));
+    CHECK(getHealthCount (HEALTH_YAW_EDGES) == 1);
+
+    // A step clears it.
+    step (SIM_ADC_RATE, true, 1);
+    CHECK(!(getHealthFaults () & HEALTH_FAULT_BIT(HEALTH_YAW_EDGES)));
+}
+
+static void
+testYawRef (void)
+{
+    // Not found in time. No steps, so the step limit is never reached.
+    start ();
+    in.rotating = true;
+    in.findingRef = true;
+    CHECK(run (2 * MS2UPDATES(HEALTH_REF_MS), SIM_ADC_RATE, true, 0,
+               HEALTH_FAULT_BIT(HEALTH_YAW_REF)) == MS2UPDATES(HEALTH_REF_MS));
+    CHECK(getHealthCount (HEALTH_YAW_REF) == 1);
+
+    // Not found within the most steps.
+    start ();
+    in.rotating = true;
+    in.findingRef = true;
+    CHECK(run (MS2UPDATES(HEALTH_REF_MS), SIM_ADC_RATE, true, 10,
+               HEALTH_FAULT_BIT(HEALTH_YAW_REF)) == HEALTH_REF_MAX_STEPS / 10 + 1);
+
+    // Clears when no longer searching, and a new search starts afresh.
+    in.findingRef = false;
+    step (SIM_ADC_RATE, true, 1);
+    CHECK(!(getHealthFaults () & HEALTH_FAULT_BIT(HEALTH_YAW_REF)));
+    in.findingRef = true;
+    step (SIM_ADC_RATE, true, 1);
+    CHECK(!(getHealthFaults () & HEALTH_FAULT_BIT(HEALTH_YAW_REF)));
+    CHECK(getHealthCount (HEALTH_YAW_REF) == 1);
+}
+
+int
+main (void)
+{
+    testHealthy ();
+    testAdcStuck ();
+    testAdcRate ();
+    testYawEdges ();
+    testYawRef ();
+    return TEST_DONE();
+}
@@ -0,0 +1,242 @@
+// *******************************************************
+//
+// testMission.c
+//
+// Host tests for scripted missions. Flies simulated altitude
+// and yaw traces through waypoint tables and checks the hold
+// timing, settle time and time in tolerance measured, the
+// yaw wrap at +-180 deg and the results log.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "testUtils.h"
+#include "mission.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define UPDATE_MS       (1000 / MISSION_UPDATE_RATE)
+
+//*****************************************************************************
+// load - Replaces the mission with the n waypoints in wps.
+//*****************************************************************************
+static void
+load (const waypoint_t *wps, uint8_t n)
+{
+    uint8_t i;
+
+    initMission ();
+    CHECK(clearMission ());
+    for (i = 0; i < n; i++)
+    {
+        CHECK(addWaypoint (&wps[i]));
+    }
+}
+
+//*****************************************************************************
+// fly - Runs n updates at alt and yawDeg. Returns the number that returned
+// the mission running.
+//*****************************************************************************
+static uint32_t
+fly (uint32_t n, float alt, float yawDeg)
+{
+    waypoint_t target;
+    uint32_t running = 0;
+
+    while (n--)
+    {
+        running += updateMission (alt, yawDeg, &target);
+    }
+    return running;
+}
+
+static void
+testTable (void)
+{
+    const waypoint_t wp = {50, 0, 1000};
+    uint8_t i;
+
+    // Starts with the default mission.
+    initMission ();
+    CHECK(getNumWaypoints () > 0);
+    CHECK(!missionArmed ());
+    CHECK(!missionRunning ());
+
+    // Only a mission with waypoints can be armed, and clearing disarms.
+    armMission (true);
+    CHECK(missionArmed ());
+    CHECK(clearMission ());
+    CHECK(!missionArmed ());
+    CHECK(getNumWaypoints () == 0);
+    armMission (true);
+    CHECK(!missionArmed ());
+    startMission ();
+    CHECK(!missionRunning ());
+
+    // Fills up.
+    for (i = 0; i < MISSION_MAX_WAYPOINTS; i++)
+    {
+        CHECK(addWaypoint (&wp));
+    }
+    CHECK(!addWaypoint (&wp));
+    CHECK(getNumWaypoints () == MISSION_MAX_WAYPOINTS);
+
+    // Starting disarms, and the table cannot change while running.
+    armMission (true);
+    startMission ();
+    CHECK(missionRunning ());
+    CHECK(!missionArmed ());
+    CHECK(!clearMission ());
+    CHECK(getNumWaypoints () == MISSION_MAX_WAYPOINTS);
+    stopMission ();
+    CHECK(!missionRunning ());
+    CHECK(clearMission ());
+    CHECK(addWaypoint (&wp));
+}
+
+static void
+testHold (void)
+{
+    const waypoint_t wps[] = {
+        {50,    0,  300},
+        {30,   90,  500},
+        {10,  -90,  200},
+    };
+    waypoint_t target;
+    uint32_t n;
+
+    // Each waypoint is the target for its hold time, whatever the heli does.
+    load (wps, 3);
+    startMission ();
+    for (n = 0; n < 30 - 1; n++)
+    {
+        CHECK(updateMission (0, 0, &target) && target.alt == 50);
+    }
+    CHECK(updateMission (0, 0, &target) && target.alt == 30 && target.yaw == 90);
+    CHECK(fly (50 - 1, 0, 0) == 50 - 1);
+    CHECK(updateMission (0, 0, &target) && target.alt == 10 && target.yaw == -90);
+
+    // The last update of the last waypoint ends the mission.
+    CHECK(fly (20, 0, 0) == 20 - 1);
+    CHECK(!missionRunning ());
+    CHECK(!updateMission (0, 0, &target));
+}
+
+static void
+testSettle (void)
+{
+    const waypoint_t wp = {50, 0, 1000};
+    wpResult_t result;
+
+    // Settled when it comes into tolerance and stays.
+    load (&wp, 1);
+    startMission ();
+    fly (30, 0, 0);
+    fly (70, 50, 0);
+    CHECK(takeMissionResult (&result));
+    CHECK(result.index == 0);
+    CHECK(result.settleMs == 30 * UPDATE_MS);
+    CHECK(result.inTolMs == 70 * UPDATE_MS);
+    CHECK(!takeMissionResult (&result));
+
+    // Leaving tolerance restarts the settle time, in tolerance time adds up.
+    startMission ();
+    fly (20, 0, 0);
+    fly (20, 50, 0);
+    fly (10, 0, 0);
+    fly (50, 50, 0);
+    CHECK(takeMissionResult (&result));
+    CHECK(result.settleMs == 50 * UPDATE_MS);
+    CHECK(result.inTolMs == 70 * UPDATE_MS);
+
+    // Not settled if it ends out of tolerance.
+    startMission ();
+    fly (90, 50, 0);
+    fly (10, 0, 0);
+    CHECK(takeMissionResult (&result));
+    CHECK(result.settleMs == MISSION_NOT_SETTLED);
+    CHECK(result.inTolMs == 90 * UPDATE_MS);
+
+    // Tolerance edges in altitude and yaw.
+    startMission ();
+    fly (25, 50 + MISSION_ALT_TOL_PER, 0);
+    fly (25, 50 - MISSION_ALT_TOL_PER - 0.5f, 0);
+    fly (25, 50, -MISSION_YAW_TOL_DEG);
+    fly (25, 50, MISSION_YAW_TOL_DEG + 0.5f);
+    CHECK(takeMissionResult (&result));
+    CHECK(result.inTolMs == 50 * UPDATE_MS);
+}
+
+static void
+testYawWrap (void)
+{
+    const waypoint_t wps[] = {
+        {50,  180,  100},
+        {50, -179,  100},
+        {50,   90,  100},
+    };
+    wpResult_t result;
+
+    // Errors are taken the short way round across +-180 deg.
+    load (wps, 3);
+    startMission ();
+    fly (10, 50, -178);
+    fly (10, 50, 179);
+    fly (10, 50, -90);
+    CHECK(takeMissionResult (&result) && result.inTolMs == 10 * UPDATE_MS);
+    CHECK(takeMissionResult (&result) && result.inTolMs == 10 * UPDATE_MS);
+    CHECK(takeMissionResult (&result) && result.inTolMs == 0);
+}
+
+static void
+testResults (void)
+{
+    const waypoint_t wps[] = {
+        {50,    0,  100},
+        {30,    0,  100},
+        {10,    0,  100},
+    };
+    wpResult_t result;
+    uint8_t i;
+
+    // A stopped waypoint is not logged.
+    load (wps, 3);
+    startMission ();
+    fly (15, 50, 0);
+    stopMission ();
+    CHECK(!fly (1, 50, 0));
+    CHECK(takeMissionResult (&result) && result.index == 0);
+    CHECK(!takeMissionResult (&result));
+
+    // Only the newest MISSION_MAX_WAYPOINTS results are kept, oldest first.
+    for (i = 0; i < 6; i++)
+    {
+        startMission ();
+        fly (30, 0, 0);
+    }
+    for (i = 0; i < MISSION_MAX_WAYPOINTS; i++)
+    {
+        CHECK(takeMissionResult (&result));
+        CHECK(result.index == (6 * 3 - MISSION_MAX_WAYPOINTS + i) % 3);
+    }
+    CHECK(!takeMissionResult (&result));
+}
+
+int
+main (void)
+{
+    testTable ();
+    testHold ();
+    testSettle ();
+    testYawWrap ();
+    testResults ();
+    return TEST_DONE();
+}
@@ -0,0 +1,299 @@
+// *******************************************************
+//
+// testStore.c
+//
+// Host tests for the EEPROM settings store, on a file backed
+// EEPROM. Covers saving and loading across resets, slot
+// alternation, writes torn at every word, corrupted records,
+// sequence number wrap and loading records from an older
+// version.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "testUtils.h"
+#include "eepromShim.h"
+#include "driverlib/eeprom.h"
+#include "heliStore.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define EEPROM_PATH     "testStore.eeprom"
+#define SLOT_BYTES      (STORE_SLOT_WORDS * 4)
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+// Layout of a record, as written by heliStore.c.
+typedef struct {
+    uint16_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint16_t reserved;
+    uint32_t seq;
+    uint32_t crc;
+} recHeader_t;
+
+typedef union {
+    struct {
+        recHeader_t header;
+        uint8_t data[SLOT_BYTES - sizeof(recHeader_t)];
+    } rec;
+    uint32_t words[STORE_SLOT_WORDS];
+} recSlot_t;
+
+//*****************************************************************************
+// crc32 - Standard CRC-32 of len bytes, continuing from crc.
+//*****************************************************************************
+static uint32_t
+crc32 (uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    uint8_t bit;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+//*****************************************************************************
+// writeRecord - Writes a record of size bytes of data straight to slot.
+//*****************************************************************************
+static void
+writeRecord (uint8_t slot, uint16_t version, uint32_t seq, const void *data, uint16_t size)
+{
+    recSlot_t rec;
+
+    memset (&rec, 0xFF, sizeof(rec));
+    rec.rec.header.magic = STORE_MAGIC;
+    rec.rec.header.version = version;
+    rec.rec.header.size = size;
+    rec.rec.header.reserved = 0;
+    rec.rec.header.seq = seq;
+    memcpy (rec.rec.data, data, size);
+    rec.rec.header.crc = crc32 (crc32 (0, (const uint8_t *) &rec.rec.header,
+                                       offsetof(recHeader_t, crc)), rec.rec.data, size);
+    EEPROMProgram (rec.words, slot * SLOT_BYTES, sizeof(rec.words));
+}
+
+//*****************************************************************************
+// reset - Acts like a reset, reopening the EEPROM file and the store.
+//*****************************************************************************
+static void
+reset (void)
+{
+    eepromShimOpen (EEPROM_PATH, false);
+    initStore ();
+}
+
+//*****************************************************************************
+// makeSettings - Fills settings with values that depend on n.
+//*****************************************************************************
+static void
+makeSettings (settings_t *settings, uint16_t n)
+{
+    defaultSettings (settings);
+    settings->altZero = 2000 + n;
+    settings->altRange = 1000 + n;
+    settings->hoverDuty = 30000 + n;
+    settings->altTune.Kp = 1.5f + n;
+    settings->yawTune.Kd = 0.5f + n;
+    settings->ffGain = 0.25f * n;
+}
+
+static bool
+settingsEqual (const settings_t *a, const settings_t *b)
+{
+    return memcmp (a, b, sizeof(settings_t)) == 0;
+}
+
+static void
+testCrc (void)
+{
+    // Standard check value.
+    CHECK(crc32 (0, (const uint8_t *) "123456789", 9) == 0xCBF43926);
+}
+
+static void
+testEmpty (void)
+{
+    settings_t loaded, defaults;
+
+    eepromShimOpen (EEPROM_PATH, true);
+    initStore ();
+    defaultSettings (&defaults);
+    CHECK(!loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &defaults));
+}
+
+static void
+testSaveLoad (void)
+{
+    settings_t saved, loaded;
+    uint16_t n;
+
+    eepromShimOpen (EEPROM_PATH, true);
+    initStore ();
+    loadSettings (&loaded);
+
+    // Each save survives a reset and is the one loaded, whichever slot it is in.
+    for (n = 0; n < 5; n++)
+    {
+        makeSettings (&saved, n);
+        CHECK(saveSettings (&saved));
+        reset ();
+        CHECK(loadSettings (&loaded));
+        CHECK(settingsEqual (&loaded, &saved));
+    }
+}
+
+static void
+testTornWrite (void)
+{
+    settings_t old, next, loaded;
+    uint32_t words;
+
+    // A reset at any point while writing leaves the last good record.
+    for (words = 0; words < STORE_SLOT_WORDS; words++)
+    {
+        eepromShimOpen (EEPROM_PATH, true);
+        initStore ();
+        loadSettings (&loaded);
+        makeSettings (&old, 1);
+        makeSettings (&next, 2);
+        CHECK(saveSettings (&old));
+        CHECK(saveSettings (&old));     // Both slots hold a record
+
+        // A tear in the last words can still leave a whole record, as the
+        // slot held the same bytes before, so either may load unless saved.
+        eepromShimTearAfter (words);
+        bool saved = saveSettings (&next);
+        reset ();
+        CHECK(loadSettings (&loaded));
+        CHECK(settingsEqual (&loaded, &next) || (!saved && settingsEqual (&loaded, &old)));
+    }
+}
+
+static void
+testCorrupt (void)
+{
+    settings_t old, next, loaded;
+    uint32_t word;
+
+    eepromShimOpen (EEPROM_PATH, true);
+    initStore ();
+    loadSettings (&loaded);
+    makeSettings (&old, 1);
+    makeSettings (&next, 2);
+    saveSettings (&old);        // Slot 0
+    saveSettings (&next);       // Slot 1
+
+    // A flipped bit in the newest record falls back to the older one.
+    EEPROMRead (&word, SLOT_BYTES + sizeof(recHeader_t), 4);
+    word ^= 0x100;
+    EEPROMProgram (&word, SLOT_BYTES + sizeof(recHeader_t), 4);
+    reset ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &old));
+
+    // The next save goes over the bad record, not the good one.
+    CHECK(saveSettings (&next));
+    reset ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &next));
+}
+
+static void
+testSeqWrap (void)
+{
+    settings_t old, next, loaded;
+
+    // Sequence 0 follows 0xFFFFFFFF, in either slot.
+    makeSettings (&old, 1);
+    makeSettings (&next, 2);
+    eepromShimOpen (EEPROM_PATH, true);
+    writeRecord (0, STORE_VERSION, UINT32_MAX, &old, sizeof(old));
+    writeRecord (1, STORE_VERSION, 0, &next, sizeof(next));
+    initStore ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &next));
+
+    eepromShimOpen (EEPROM_PATH, true);
+    writeRecord (0, STORE_VERSION, 0, &next, sizeof(next));
+    writeRecord (1, STORE_VERSION, UINT32_MAX, &old, sizeof(old));
+    initStore ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &next));
+
+    // Saving after the wrap carries on from the newest.
+    CHECK(saveSettings (&old));
+    reset ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &old));
+}
+
+static void
+testMigrate (void)
+{
+    // Version 0 records held only the altitude calibration and hover duty.
+    struct {
+        uint16_t altZero;
+        uint16_t altRange;
+        uint32_t hoverDuty;
+    } v0 = {2345, 1234, 31000};
+    settings_t expected, loaded, newer;
+
+    eepromShimOpen (EEPROM_PATH, true);
+    writeRecord (0, 0, 7, &v0, sizeof(v0));
+    initStore ();
+    defaultSettings (&expected);
+    expected.altZero = v0.altZero;
+    expected.altRange = v0.altRange;
+    expected.hoverDuty = v0.hoverDuty;
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &expected));
+
+    // Saving writes the current version to the other slot, which then loads.
+    makeSettings (&newer, 3);
+    CHECK(saveSettings (&newer));
+    reset ();
+    CHECK(loadSettings (&loaded));
+    CHECK(settingsEqual (&loaded, &newer));
+
+    // Records from a later version are ignored.
+    eepromShimOpen (EEPROM_PATH, true);
+    writeRecord (0, STORE_VERSION + 1, 8, &newer, sizeof(newer));
+    initStore ();
+    CHECK(!loadSettings (&loaded));
+}
+
+int
+main (void)
+{
+    testCrc ();
+    testEmpty ();
+    testSaveLoad ();
+    testTornWrite ();
+    testCorrupt ();
+    testSeqWrap ();
+    testMigrate ();
+    eepromShimClose ();
+    remove (EEPROM_PATH);
+    return TEST_DONE();
+}
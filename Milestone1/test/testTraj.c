@@ -0,0 +1,227 @@
+// *******************************************************
+//
+// testTraj.c
+//
+// Host tests for the setpoint trajectory generator. Moves
+// are run to the end, checking the rate and acceleration
+// limits on every step, the profile shape, the stop at the
+// target and the shortest way round for angles.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "testUtils.h"
+#include "trajectory.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define DT          0.01f       // Time step in s
+#define MAX_VEL     10.0f       // Rate limit in units/s
+#define MAX_ACC     5.0f        // Acceleration limit in units/s^2
+#define LIMIT_TOL   1e-4f       // Float rounding allowed on the rate limit
+#define ACC_TOL     1.01f       // Float rounding allowed on the acceleration limit
+#define MAX_STEPS   100000
+
+//*****************************************************************************
+// Types
+//*****************************************************************************
+typedef struct {
+    uint32_t steps;     // Steps until stopped at the target
+    float peakVel;      // Largest rate reached
+    float travel;       // Distance moved, the short way round for angles
+    bool inLimits;      // Rate and acceleration within limits on every step
+    bool overshot;      // Passed the target
+    bool inRange;       // Angle stayed within +-wrap/2
+} move_t;
+
+//*****************************************************************************
+// wrapDist - Returns d the short way round for an angle trajectory.
+//*****************************************************************************
+static float
+wrapDist (const traj_t *traj, float d)
+{
+    if (traj->wrap > 0)
+    {
+        d = fmodf (d, traj->wrap);
+        if (d >= traj->wrap / 2)
+        {
+            d -= traj->wrap;
+        }
+        else if (d < -traj->wrap / 2)
+        {
+            d += traj->wrap;
+        }
+    }
+    return d;
+}
+
+//*****************************************************************************
+// fly - Runs traj towards target for at most maxSteps, or until it stops
+// there, checking each step.
+//*****************************************************************************
+static move_t
+fly (traj_t *traj, float target, uint32_t maxSteps)
+{
+    move_t move = {0, 0, 0, true, false, true};
+    float startSide = wrapDist (traj, target - traj->pos);
+
+    while (move.steps < maxSteps && !(traj->pos == wrapDist (traj, target) && traj->vel == 0))
+    {
+        float pos = traj->pos, vel = traj->vel;
+
+        updateTraj (traj, target, DT);
+        move.steps++;
+
+        float moved = wrapDist (traj, traj->pos - pos);
+        move.travel += fabsf (moved);
+        if (fabsf (traj->vel) > move.peakVel)
+        {
+            move.peakVel = fabsf (traj->vel);
+        }
+        if (fabsf (traj->vel) > MAX_VEL + LIMIT_TOL ||
+            fabsf (traj->vel - vel) > MAX_ACC * DT * ACC_TOL ||
+            fabsf (moved) > MAX_VEL * DT + LIMIT_TOL)
+        {
+            move.inLimits = false;
+        }
+        if (wrapDist (traj, target - traj->pos) * startSide < 0)
+        {
+            move.overshot = true;
+        }
+        if (traj->wrap > 0 && (traj->pos < -traj->wrap / 2 || traj->pos >= traj->wrap / 2))
+        {
+            move.inRange = false;
+        }
+    }
+    return move;
+}
+
+static void
+testTrapezoid (void)
+{
+    traj_t traj;
+    move_t move;
+
+    // A long move cruises at the rate limit, taking d/v + v/a.
+    initTraj (&traj, MAX_VEL, MAX_ACC, 0);
+    move = fly (&traj, 100, MAX_STEPS);
+    CHECK(traj.pos == 100 && traj.vel == 0);
+    CHECK(move.inLimits);
+    CHECK(!move.overshot);
+    CHECK(fabsf (move.peakVel - MAX_VEL) < LIMIT_TOL);
+    CHECK(fabsf (move.steps * DT - (100 / MAX_VEL + MAX_VEL / MAX_ACC)) < 0.1f);
+
+    // And back down.
+    move = fly (&traj, -20, MAX_STEPS);
+    CHECK(traj.pos == -20 && traj.vel == 0);
+    CHECK(move.inLimits && !move.overshot);
+}
+
+static void
+testTriangle (void)
+{
+    traj_t traj;
+    move_t move;
+
+    // A short move never reaches the rate limit, peaking at sqrt(a d) after
+    // accelerating for half the distance, taking 2 sqrt(d / a).
+    initTraj (&traj, MAX_VEL, MAX_ACC, 0);
+    move = fly (&traj, 5, MAX_STEPS);
+    CHECK(traj.pos == 5 && traj.vel == 0);
+    CHECK(move.inLimits && !move.overshot);
+    CHECK(move.peakVel < MAX_VEL);
+    CHECK(fabsf (move.peakVel - sqrtf (MAX_ACC * 5)) < 0.05f * sqrtf (MAX_ACC * 5));
+    CHECK(fabsf (move.steps * DT - 2 * sqrtf (5 / MAX_ACC)) < 0.1f);
+
+    // A move shorter than one step's rate change is made in one step, and
+    // the rate falls back to zero on the next.
+    move = fly (&traj, 5.0001f, MAX_STEPS);
+    CHECK(traj.pos == 5.0001f && traj.vel == 0);
+    CHECK(move.steps == 2 && move.inLimits);
+
+    // Already there, nothing moves.
+    CHECK(updateTraj (&traj, 5.0001f, DT) == 5.0001f && traj.vel == 0);
+}
+
+static void
+testWrap (void)
+{
+    traj_t traj;
+    move_t move;
+
+    // Across +-180 the short way, staying within range.
+    initTraj (&traj, MAX_VEL, MAX_ACC, 360);
+    resetTraj (&traj, 170);
+    move = fly (&traj, -170, MAX_STEPS);
+    CHECK(traj.pos == -170 && traj.vel == 0);
+    CHECK(fabsf (move.travel - 20) < 0.01f);
+    CHECK(move.inLimits && !move.overshot && move.inRange);
+
+    move = fly (&traj, 170, MAX_STEPS);
+    CHECK(traj.pos == 170 && traj.vel == 0);
+    CHECK(fabsf (move.travel - 20) < 0.01f);
+    CHECK(move.inLimits && !move.overshot && move.inRange);
+
+    // A target given outside the range is the same angle.
+    resetTraj (&traj, 0);
+    move = fly (&traj, -350, MAX_STEPS);
+    CHECK(traj.pos == 10 && traj.vel == 0);
+    CHECK(fabsf (move.travel - 10) < 0.01f);
+
+    // Starting outside the range is taken back within it.
+    resetTraj (&traj, 190);
+    CHECK(traj.pos == -170);
+}
+
+static void
+testRetarget (void)
+{
+    traj_t traj;
+    move_t move;
+
+    // Retarget behind while at full rate: slows at the acceleration limit,
+    // then comes back to the new target without passing it.
+    initTraj (&traj, MAX_VEL, MAX_ACC, 0);
+    fly (&traj, 100, 500);
+    CHECK(fabsf (traj.vel - MAX_VEL) < LIMIT_TOL);
+    float stopDist = MAX_VEL * MAX_VEL / (2 * MAX_ACC) - MAX_VEL * DT / 2;   // Braking in steps
+    float turnPos = traj.pos + stopDist;
+    move = fly (&traj, 0, MAX_STEPS);
+    CHECK(traj.pos == 0 && traj.vel == 0);
+    CHECK(move.inLimits && !move.overshot);
+    CHECK(fabsf (move.travel - (stopDist + turnPos)) < 0.01f);
+
+    // Retarget ahead while stopping, speeds up again without a jump.
+    fly (&traj, 50, 350);
+    CHECK(traj.vel > 0);
+    move = fly (&traj, 80, MAX_STEPS);
+    CHECK(traj.pos == 80 && traj.vel == 0);
+    CHECK(move.inLimits && !move.overshot);
+
+    // Retarget to where it is while moving, must stop past it and come back.
+    fly (&traj, 0, 300);
+    float here = traj.pos;
+    move = fly (&traj, here, MAX_STEPS);
+    CHECK(traj.pos == here && traj.vel == 0);
+    CHECK(move.inLimits);
+    CHECK(move.travel > MAX_VEL * MAX_VEL / MAX_ACC - 0.5f);
+}
+
+int
+main (void)
+{
+    testTrapezoid ();
+    testTriangle ();
+    testWrap ();
+    testRetarget ();
+    return TEST_DONE();
+}
@@ -0,0 +1,41 @@
+#ifndef TESTUTILS_H_
+#define TESTUTILS_H_
+
+// *******************************************************
+//
+// testUtils.h
+//
+// Checks for the host tests. Each test is its own program
+// that runs its cases, prints any failed checks and exits
+// non-zero if there were any.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdio.h>
+
+static int testChecks = 0;
+static int testFailures = 0;
+
+// Counts a check, printing where it failed if COND is false.
+#define CHECK(COND) \
+    do { \
+        testChecks++; \
+        if (!(COND)) \
+        { \
+            testFailures++; \
+            printf ("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #COND); \
+        } \
+    } while (0)
+
+// Prints the totals and gives the exit code for main.
+#define TEST_DONE() \
+    (printf ("%s: %d checks, %d failed\n", __FILE__, testChecks, testFailures), \
+     testFailures != 0)
+
+#endif /* TESTUTILS_H_ */
@@ -0,0 +1,120 @@
+// *******************************************************
+//
+// testYaw.c
+//
+// Host tests for the yaw binary angle conversions in yaw.h.
+// Every tab count and degree over several turns is checked
+// against exact rational arithmetic.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "testUtils.h"
+#include "yaw.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define ANGLE_CIRC      65536       // Binary angle units in a turn
+#define TAB_TURNS       100         // Turns each way the tab conversion is checked over
+#define DEG_TURNS       100         // Turns each way the degree conversion is checked over
+
+//*****************************************************************************
+// divRound - Returns num / den rounded to nearest, halves up, for den > 0.
+//*****************************************************************************
+static int64_t
+divRound (int64_t num, int64_t den)
+{
+    int64_t q = (2 * num + den) / (2 * den);
+    // C division truncates, step down for negative results.
+    if ((2 * num + den) % (2 * den) != 0 && (2 * num + den) < 0)
+    {
+        q--;
+    }
+    return q;
+}
+
+//*****************************************************************************
+// divFloor - Returns num / den rounded down, for den > 0.
+//*****************************************************************************
+static int64_t
+divFloor (int64_t num, int64_t den)
+{
+    int64_t q = num / den;
+    if (num % den != 0 && num < 0)
+    {
+        q--;
+    }
+    return q;
+}
+
+//*****************************************************************************
+// wrapAngle - Wraps an exact angle into the int16 binary angle range.
+//*****************************************************************************
+static yawAngle_t
+wrapAngle (int64_t angle)
+{
+    return (yawAngle_t) (uint16_t) (angle & (ANGLE_CIRC - 1));
+}
+
+static void
+testTab2Angle (void)
+{
+    int32_t tab;
+
+    for (tab = -TAB_TURNS * YAW_TABS; tab <= TAB_TURNS * YAW_TABS; tab++)
+    {
+        CHECK(YAW_TAB2ANGLE(tab) == wrapAngle (divRound ((int64_t) tab * ANGLE_CIRC, YAW_TABS)));
+    }
+}
+
+static void
+testDeg2Angle (void)
+{
+    int32_t deg;
+
+    for (deg = -DEG_TURNS * DEG_CIRC; deg <= DEG_TURNS * DEG_CIRC; deg++)
+    {
+        CHECK(YAW_DEG2ANGLE(deg) == wrapAngle (divRound ((int64_t) deg * ANGLE_CIRC, DEG_CIRC)));
+    }
+}
+
+static void
+testAngle2Units (void)
+{
+    int32_t angle;
+
+    for (angle = INT16_MIN; angle <= INT16_MAX; angle++)
+    {
+        CHECK(YAW_ANGLE2DEG(angle) == divRound ((int64_t) angle * DEG_CIRC, ANGLE_CIRC));
+        CHECK(YAW_ANGLE2DDEG(angle) == divRound ((int64_t) angle * DEG_CIRC * 10, ANGLE_CIRC));
+        CHECK(YAW_ANGLE2MDEG(angle) == divFloor ((int64_t) angle * DEG_CIRC * 1000, ANGLE_CIRC));
+    }
+}
+
+static void
+testWrap (void)
+{
+    // Differences wrap the short way round at +-180 deg.
+    CHECK(YAW_ANGLE2DEG((yawAngle_t) (YAW_DEG2ANGLE(170) - YAW_DEG2ANGLE(-170))) == -20);
+    CHECK(YAW_ANGLE2DEG((yawAngle_t) (YAW_DEG2ANGLE(-170) - YAW_DEG2ANGLE(170))) == 20);
+    CHECK(YAW_TAB2ANGLE(YAW_TABS) == 0);
+    CHECK(YAW_TAB2ANGLE(YAW_TABS / 2) == INT16_MIN);
+}
+
+int
+main (void)
+{
+    testTab2Angle ();
+    testDeg2Angle ();
+    testAngle2Units ();
+    testWrap ();
+    return TEST_DONE();
+}
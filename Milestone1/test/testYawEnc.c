@@ -0,0 +1,336 @@
+// *******************************************************
+//
+// testYawEnc.c
+//
+// Host tests for the yaw quadrature decoder and rate
+// estimate. Synthetic pin edge streams are fed through
+// yawIntHandler and the steps, illegal transitions and
+// yaw rate found are checked.
+//
+// Author:  Zeb Barry           ID: 79313790
+// Author:  Mitchell Hollows    ID: 23567059
+// Author:  Jack Topliss        ID: 46510499
+// Group:   Thu am 22
+// Last modified:   19.10.2026
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "testUtils.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "yaw.h"
+#include "heliTimer.h"
+
+//*****************************************************************************
+// Constants
+//*****************************************************************************
+#define SIM_CLOCK_HZ    20000000    // Clock rate given by the fake SysCtlClockGet
+#define UPDATE_MS       10          // Time between rate updates
+
+// Pin states in the order they are passed through turning CCW, A leading B.
+static const uint8_t ccwCycle[4] = {BOTH_ZERO, A_ONE, BOTH_ONE, B_ONE};
+
+//*****************************************************************************
+// Static variables
+//*****************************************************************************
+static uint8_t simPins;     // Encoder pin states, A in bit 0 and B in bit 1
+static uint32_t simTicks;   // Fake down counting timer
+
+//*****************************************************************************
+// Fakes for the hardware used by yaw.c
+//*****************************************************************************
+int32_t
+GPIOPinRead (uint32_t port, uint8_t pins)
+{
+    return (port == YAW_PORT_BASE) ? simPins & pins : 0;
+}
+
+uint32_t
+SysCtlClockGet (void)
+{
+    return SIM_CLOCK_HZ;
+}
+
+uint32_t
+timerGet (void)
+{
+    return simTicks;
+}
+
+bool
+IntMasterDisable (void)
+{
+    return false;
+}
+
+bool
+IntMasterEnable (void)
+{
+    return false;
+}
+
+void SysCtlPeripheralEnable (uint32_t peripheral) {}
+void GPIOPinTypeGPIOInput (uint32_t port, uint8_t pins) {}
+void GPIOPadConfigSet (uint32_t port, uint8_t pins, uint32_t strength, uint32_t type) {}
+void GPIOIntTypeSet (uint32_t port, uint8_t pins, uint32_t type) {}
+void GPIOIntRegister (uint32_t port, void (*handler) (void)) {}
+void GPIOIntEnable (uint32_t port, uint32_t flags) {}
+void GPIOIntDisable (uint32_t port, uint32_t flags) {}
+uint32_t GPIOIntStatus (uint32_t port, bool masked) { return 0; }
+void GPIOIntClear (uint32_t port, uint32_t flags) {}
+
+//*****************************************************************************
+// cyclePos - Returns where state is in the CCW cycle.
+//*****************************************************************************
+static uint8_t
+cyclePos (uint8_t state)
+{
+    uint8_t i;
+
+    for (i = 0; ccwCycle[i] != state; i++)
+    {
+    }
+    return i;
+}
+
+//*****************************************************************************
+// edge - Changes the pins to state and runs the pin change interrupt.
+//*****************************************************************************
+static void
+edge (uint8_t state)
+{
+    simPins = state;
+    yawIntHandler ();
+}
+
+//*****************************************************************************
+// turn - Steps the pins n steps around the cycle from their current state,
+// CCW if dir is CCW and CW otherwise.
+//*****************************************************************************
+static void
+turn (int8_t dir, uint32_t n)
+{
+    uint8_t pos = cyclePos (simPins);
+
+    while (n--)
+    {
+        pos = (pos + (dir == CCW ? 1 : 3)) % 4;
+        edge (ccwCycle[pos]);
+    }
+}
+
+//*****************************************************************************
+// wait - Moves the fake timer on ms.
+//*****************************************************************************
+static void
+wait (uint32_t ms)
+{
+    simTicks -= ms * (SIM_CLOCK_HZ / 1000);
+}
+
+//*****************************************************************************
+// near - Returns true if rate is within 0.1 % of expected.
+//*****************************************************************************
+static bool
+near (float rate, float expected)
+{
+    return fabsf (rate - expected) <= 1e-3f * fabsf (expected);
+}
+
+//*****************************************************************************
+// start - Initialises the decoder with the pins in state.
+//*****************************************************************************
+static void
+start (uint8_t state)
+{
+    simPins = state;
+    simTicks = 0;
+    initYaw ();
+}
+
+static void
+testTransitions (void)
+{
+    uint8_t prev, cur;
+
+    // Every pair of pin states, against the step expected from the cycle:
+    // one on is CCW, one back is CW, two on is a missed step.
+    for (prev = 0; prev < 4; prev++)
+    {
+        for (cur = 0; cur < 4; cur++)
+        {
+            uint8_t ahead = (cyclePos (cur) + 4 - cyclePos (prev)) % 4;
+            int32_t expected = (ahead == 1) ? CCW : (ahead == 3) ? CW : STATIC;
+
+            start (prev);
+            uint32_t edges = getYawEdgeCount ();
+            edge (cur);
+            CHECK(yaw == expected);
+            CHECK(getYawIllegalCount () == (ahead == 2));
+            CHECK(getYawEdgeCount () - edges == (expected != STATIC));
+        }
+    }
+}
+
+static void
+testStreams (void)
+{
+    // Whole turns each way come back to the start.
+    start (BOTH_ZERO);
+    uint32_t edges = getYawEdgeCount ();
+    turn (CCW, YAW_TABS);
+    CHECK(yaw == -YAW_TABS);
+    turn (CW, 2 * YAW_TABS);
+    CHECK(yaw == YAW_TABS);
+    turn (CCW, YAW_TABS);
+    CHECK(yaw == 0);
+    CHECK(getYawIllegalCount () == 0);
+    CHECK(getYawEdgeCount () - edges == 4 * YAW_TABS);
+
+    // Turning back and forth on one edge, as a chattering pin does.
+    start (BOTH_ZERO);
+    edges = getYawEdgeCount ();
+    uint16_t i;
+    for (i = 0; i < 100; i++)
+    {
+        edge (A_ONE);
+        edge (BOTH_ZERO);
+    }
+    CHECK(yaw == 0);
+    CHECK(getYawIllegalCount () == 0);
+
+    // Repeated interrupts with no pin change do nothing.
+    edge (BOTH_ZERO);
+    CHECK(yaw == 0);
+    CHECK(getYawEdgeCount () - edges == 200);
+
+    // Missed steps are counted and do not move the yaw.
+    start (BOTH_ZERO);
+    turn (CW, 10);
+    edge (ccwCycle[(cyclePos (simPins) + 2) % 4]);
+    turn (CW, 10);
+    CHECK(yaw == 20);
+    CHECK(getYawIllegalCount () == 1);
+
+    // The reference resets the yaw but not the counts.
+    yawRefIntHandler ();
+    CHECK(yaw == 0 && hitYawRef);
+    CHECK(getYawIllegalCount () == 1);
+}
+
+static void
+testRateCount (void)
+{
+    uint8_t i, j;
+
+    // Several steps per update, the rate is from the count.
+    start (BOTH_ZERO);
+    for (i = 0; i < 10; i++)
+    {
+        for (j = 0; j < 5; j++)
+        {
+            wait (UPDATE_MS / 5);
+            turn (CW, 1);
+        }
+        updateYawRate ();
+        CHECK(near (getYawRate (), 5 * YAW_DEG_PER_STEP * 1000 / UPDATE_MS));
+    }
+
+    // CCW is negative.
+    for (i = 0; i < 3; i++)
+    {
+        turn (CCW, 2 * YAW_RATE_COUNT_STEPS);
+        wait (UPDATE_MS);
+        updateYawRate ();
+    }
+    CHECK(near (getYawRate (), -2 * YAW_RATE_COUNT_STEPS * YAW_DEG_PER_STEP * 1000 / UPDATE_MS));
+}
+
+static void
+testRatePeriod (void)
+{
+    const float periodRate = YAW_DEG_PER_STEP * 1000 / 30;
+    uint8_t i;
+
+    // A step every 30 ms, the rate is from the time between steps.
+    start (BOTH_ZERO);
+    for (i = 0; i < 5; i++)
+    {
+        wait (30);
+        turn (CCW, 1);
+        updateYawRate ();
+    }
+    CHECK(near (getYawRate (), -periodRate));
+
+    // A late step means the rate is at most one step over the time since.
+    wait (UPDATE_MS);
+    updateYawRate ();
+    CHECK(near (getYawRate (), -periodRate));
+    wait (40);
+    updateYawRate ();
+    CHECK(near (getYawRate (), -YAW_DEG_PER_STEP * 1000 / 50));
+
+    // A change of direction has no period yet.
+    wait (20);
+    turn (CW, 1);
+    updateYawRate ();
+    CHECK(getYawRate () == 0);
+    wait (30);
+    turn (CW, 1);
+    updateYawRate ();
+    CHECK(near (getYawRate (), periodRate));
+}
+
+static void
+testRateTimeout (void)
+{
+    const float periodRate = YAW_DEG_PER_STEP * 1000 / 30;
+    uint32_t ms;
+    uint8_t i;
+
+    start (BOTH_ZERO);
+    for (i = 0; i < 3; i++)
+    {
+        wait (30);
+        turn (CW, 1);
+        updateYawRate ();
+    }
+
+    // Slows while within the timeout, then falls to zero.
+    for (ms = UPDATE_MS; ms <= YAW_RATE_TIMEOUT_MS; ms += UPDATE_MS)
+    {
+        wait (UPDATE_MS);
+        updateYawRate ();
+        CHECK(getYawRate () > 0);
+    }
+    wait (UPDATE_MS);
+    updateYawRate ();
+    CHECK(getYawRate () == 0);
+
+    // The stale step is forgotten, so the next step in the same direction
+    // does not give a period from it, then the one after does.
+    wait (500);
+    updateYawRate ();
+    turn (CW, 1);
+    updateYawRate ();
+    CHECK(getYawRate () == 0);
+    wait (30);
+    turn (CW, 1);
+    updateYawRate ();
+    CHECK(near (getYawRate (), periodRate));
+}
+
+int
+main (void)
+{
+    testTransitions ();
+    testStreams ();
+    testRateCount ();
+    testRatePeriod ();
+    testRateTimeout ();
+    return TEST_DONE();
+}